@@ -0,0 +1,59 @@
+/**
+ * @file bench_common.h
+ * @brief Random inputs shared by the microbenchmarks.
+ * @author Martin Henrique Viana Adam
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <random>
+#include <vector>
+
+/**
+ * @brief Returns a random real number in [min, max), as required by vec<T, N>::random.
+ *
+ * Every benchmark uses the same fixed seed, so the inputs are identical between runs.
+ */
+inline double random_double(double min, double max) {
+    static std::mt19937 generator(42);
+    return std::uniform_real_distribution<double>(min, max)(generator);
+}
+
+#include "../includes/vec3xN.h"
+#include "../includes/transform.h"
+
+/**
+ * @brief Generates `count` random vectors with components in [-10, 10).
+ */
+template <typename V>
+std::vector<V> random_vectors(size_t count) {
+    std::vector<V> v(count);
+    for (V& x : v)
+        x = V::random(-10, 10);
+    return v;
+}
+
+/**
+ * @brief Generates `count` random floats in [-10, 10), e.g. packed xyz coordinates.
+ */
+inline std::vector<float> random_floats(size_t count) {
+    std::vector<float> v(count);
+    for (float& x : v)
+        x = static_cast<float>(random_double(-10, 10));
+    return v;
+}
+
+/**
+ * @brief Generates an invertible affine transform (rotation, non-uniform scale and translation).
+ */
+inline mat4 random_transform() {
+    return mat4::translation(vec3::random(-10, 10)) *
+           mat4::rotation(vec3::random(-1, 1), random_double(0, 3)) *
+           mat4::scaling(vec3::random(0.5, 2));
+}
+
+/// Array sizes of the benchmarks over large arrays: 1 Ki to 1 Mi elements.
+#define BENCH_ARRAY_SIZES RangeMultiplier(32)->Range(1 << 10, 1 << 20)
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file bench_mat.cpp
+ * @brief Microbenchmarks of the matrix operations and of the batch transforms of transform.h.
+ * @author Martin Henrique Viana Adam
+ */
+
+#include "benchmark/benchmark.h"
+#include "bench_common.h"
+
+#include <cstring>
+
+// Single values
+
+static void BM_Mat4Multiply(benchmark::State& state) {
+    mat4 a = random_transform(), b = random_transform();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_Mat4Multiply);
+
+static void BM_Mat4Inverse(benchmark::State& state) {
+    mat4 a = random_transform();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.inverse());
+    }
+}
+BENCHMARK(BM_Mat4Inverse);
+
+static void BM_Mat4Determinant(benchmark::State& state) {
+    mat4 a = random_transform();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.determinant());
+    }
+}
+BENCHMARK(BM_Mat4Determinant);
+
+static void BM_Mat3Inverse(benchmark::State& state) {
+    mat3 a = random_transform().upper_left();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a.inverse());
+    }
+}
+BENCHMARK(BM_Mat3Inverse);
+
+static void BM_NormalMatrix(benchmark::State& state) {
+    mat4 a = random_transform();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(normal_matrix(a));
+    }
+}
+BENCHMARK(BM_NormalMatrix);
+
+static void BM_TransformPoint(benchmark::State& state) {
+    mat4 m = random_transform();
+    point3 p = vec3::random(-10, 10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p);
+        benchmark::DoNotOptimize(transform_point(m, p));
+    }
+}
+BENCHMARK(BM_TransformPoint);
+
+// Arrays of packed xyz floats
+
+static void BM_TransformPointsScalar(benchmark::State& state) {
+    const size_t n = state.range(0);
+    mat4 m = random_transform();
+    std::vector<float> in = random_floats(3 * n), out(3 * n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            point3 p = transform_point(m, point3(in[3*i], in[3*i + 1], in[3*i + 2]));
+            out[3*i] = static_cast<float>(p.x());
+            out[3*i + 1] = static_cast<float>(p.y());
+            out[3*i + 2] = static_cast<float>(p.z());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * 2 * in.size() * sizeof(float));
+}
+BENCHMARK(BM_TransformPointsScalar)->BENCH_ARRAY_SIZES;
+
+static void BM_TransformPoints(benchmark::State& state) {
+    const size_t n = state.range(0);
+    mat4 m = random_transform();
+    std::vector<float> in = random_floats(3 * n), out(3 * n);
+    for (auto _ : state) {
+        transform_points(m, in.data(), out.data(), n);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * 2 * in.size() * sizeof(float));
+}
+BENCHMARK(BM_TransformPoints)->BENCH_ARRAY_SIZES;
+
+static void BM_TransformNormals(benchmark::State& state) {
+    const size_t n = state.range(0);
+    mat3 m = normal_matrix(random_transform());
+    std::vector<float> in = random_floats(3 * n), out(3 * n);
+    for (auto _ : state) {
+        transform_normals(m, in.data(), out.data(), n);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * 2 * in.size() * sizeof(float));
+}
+BENCHMARK(BM_TransformNormals)->BENCH_ARRAY_SIZES;
+
+// Memory bandwidth bound of the batch transforms: the same bytes copied without arithmetic.
+static void BM_Memcpy(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<float> in = random_floats(3 * n), out(3 * n);
+    for (auto _ : state) {
+        std::memcpy(out.data(), in.data(), in.size() * sizeof(float));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * 2 * in.size() * sizeof(float));
+}
+BENCHMARK(BM_Memcpy)->BENCH_ARRAY_SIZES;
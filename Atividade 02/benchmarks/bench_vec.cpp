@@ -0,0 +1,150 @@
+/**
+ * @file bench_vec.cpp
+ * @brief Microbenchmarks of the vector operations: single values, arrays of vec3 and vec3x8 packets.
+ * @author Martin Henrique Viana Adam
+ */
+
+#include "benchmark/benchmark.h"
+#include "bench_common.h"
+
+// Single values
+
+static void BM_Dot(benchmark::State& state) {
+    vec3 u = vec3::random(-10, 10), v = vec3::random(-10, 10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u);
+        benchmark::DoNotOptimize(dot(u, v));
+    }
+}
+BENCHMARK(BM_Dot);
+
+static void BM_Cross(benchmark::State& state) {
+    vec3 u = vec3::random(-10, 10), v = vec3::random(-10, 10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u);
+        benchmark::DoNotOptimize(cross(u, v));
+    }
+}
+BENCHMARK(BM_Cross);
+
+static void BM_UnitVector(benchmark::State& state) {
+    vec3 u = vec3::random(-10, 10);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(u);
+        benchmark::DoNotOptimize(unit_vector(u));
+    }
+}
+BENCHMARK(BM_UnitVector);
+
+static void BM_Random(benchmark::State& state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(vec3::random(-1, 1));
+}
+BENCHMARK(BM_Random);
+
+// Arrays of vec3 (array of structures)
+
+template <typename V>
+static void BM_DotArray(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<V> u = random_vectors<V>(n), v = random_vectors<V>(n);
+    std::vector<typename V::value_type> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = dot(u[i], v[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_DotArray, vec3)->BENCH_ARRAY_SIZES;
+BENCHMARK_TEMPLATE(BM_DotArray, vec3f)->BENCH_ARRAY_SIZES;
+
+template <typename V>
+static void BM_CrossArray(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<V> u = random_vectors<V>(n), v = random_vectors<V>(n), out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = cross(u[i], v[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_CrossArray, vec3)->BENCH_ARRAY_SIZES;
+BENCHMARK_TEMPLATE(BM_CrossArray, vec3f)->BENCH_ARRAY_SIZES;
+
+template <typename V>
+static void BM_UnitVectorArray(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<V> u = random_vectors<V>(n), out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = unit_vector(u[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_UnitVectorArray, vec3)->BENCH_ARRAY_SIZES;
+BENCHMARK_TEMPLATE(BM_UnitVectorArray, vec3f)->BENCH_ARRAY_SIZES;
+
+static void BM_RandomArray(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<vec3> out(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = vec3::random(-1, 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_RandomArray)->BENCH_ARRAY_SIZES;
+
+// Arrays of vec3x8 packets (structure of arrays, 8 float lanes)
+
+/**
+ * @brief Converts an array of vec3f to vec3x8 packets (the size must be a multiple of 8).
+ */
+static std::vector<vec3x8> to_packets(const std::vector<vec3f>& v) {
+    std::vector<vec3x8> packets(v.size() / 8);
+    for (size_t i = 0; i < packets.size(); i++)
+        packets[i] = vec3x8::load(&v[8 * i]);
+    return packets;
+}
+
+static void BM_DotArray_vec3x8(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<vec3x8> u = to_packets(random_vectors<vec3f>(n)), v = to_packets(random_vectors<vec3f>(n));
+    std::vector<floatx8> out(u.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < u.size(); i++)
+            out[i] = dot(u[i], v[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_DotArray_vec3x8)->BENCH_ARRAY_SIZES;
+
+static void BM_CrossArray_vec3x8(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<vec3x8> u = to_packets(random_vectors<vec3f>(n)), v = to_packets(random_vectors<vec3f>(n));
+    std::vector<vec3x8> out(u.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < u.size(); i++)
+            out[i] = cross(u[i], v[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_CrossArray_vec3x8)->BENCH_ARRAY_SIZES;
+
+static void BM_UnitVectorArray_vec3x8(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<vec3x8> u = to_packets(random_vectors<vec3f>(n)), out(u.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < u.size(); i++)
+            out[i] = unit_vector(u[i]);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_UnitVectorArray_vec3x8)->BENCH_ARRAY_SIZES;
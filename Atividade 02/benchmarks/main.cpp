@@ -0,0 +1,11 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of the microbenchmarks of the vector and matrix library.
+ * @author Martin Henrique Viana Adam
+ *
+ * Run with `--benchmark_out=results.json --benchmark_out_format=json` to save the results.
+ */
+
+#include "benchmark/benchmark.h"
+
+BENCHMARK_MAIN();
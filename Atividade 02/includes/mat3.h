@@ -49,8 +49,87 @@ public:
     const vec3 &operator[](int i) const {
         return rows[i];
     }
+
+    /**
+     * @brief Returns the 3x3 identity matrix.
+     * @return The identity matrix.
+     */
+    static mat3 identity() {
+        return mat3(vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1));
+    }
+
+    /**
+     * @brief Calculates the transpose of the matrix.
+     * @return The transposed matrix.
+     */
+    mat3 transpose() const {
+        return mat3(vec3(rows[0].x(), rows[1].x(), rows[2].x()),
+                    vec3(rows[0].y(), rows[1].y(), rows[2].y()),
+                    vec3(rows[0].z(), rows[1].z(), rows[2].z()));
+    }
+
+    /**
+     * @brief Calculates the determinant of the matrix (triple product of the rows).
+     * @return The determinant of the matrix.
+     */
+    real determinant() const {
+        return dot(rows[0], cross(rows[1], rows[2]));
+    }
+
+    /**
+     * @brief Calculates the transpose of the inverse (the cofactor matrix divided by the determinant).
+     *
+     * Its rows are the cross products of pairs of rows of this matrix. This is the matrix that
+     * transforms normals when this matrix transforms points.
+     *
+     * @pre The matrix is invertible (non-zero determinant).
+     * @return The inverse transpose of the matrix.
+     */
+    mat3 inverse_transpose() const {
+        vec3 c0 = cross(rows[1], rows[2]);
+        vec3 c1 = cross(rows[2], rows[0]);
+        vec3 c2 = cross(rows[0], rows[1]);
+        real inv_det = 1 / dot(rows[0], c0);
+        return mat3(c0 * inv_det, c1 * inv_det, c2 * inv_det);
+    }
+
+    /**
+     * @brief Calculates the inverse of the matrix.
+     * @pre The matrix is invertible (non-zero determinant).
+     * @return The inverse of the matrix.
+     */
+    mat3 inverse() const {
+        return inverse_transpose().transpose();
+    }
 };
 
+/**
+ * @brief Overloads the * operator to multiply two matrices.
+ *
+ * Each row of the product is a linear combination of the rows of b, which the compiler
+ * vectorizes without shuffles.
+ *
+ * @param a The left matrix.
+ * @param b The right matrix.
+ * @return The product a * b.
+ */
+inline mat3 operator*(const mat3 &a, const mat3 &b) {
+    mat3 r;
+    for (int i = 0; i < 3; i++)
+        r[i] = a[i].x() * b[0] + a[i].y() * b[1] + a[i].z() * b[2];
+    return r;
+}
+
+/**
+ * @brief Overloads the * operator to multiply a matrix by a column vector.
+ * @param m The matrix.
+ * @param v The vector.
+ * @return The product m * v.
+ */
+inline vec3 operator*(const mat3 &m, const vec3 &v) {
+    return vec3(dot(m[0], v), dot(m[1], v), dot(m[2], v));
+}
+
 /**
  * @brief Overloads the << operator to print the matrix.
  * @param out The output stream to print to.
@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include <iostream>
+#include "mat3.h"
 #include "vec4.h"
 
 /**
@@ -38,6 +39,15 @@ class mat4 {
         rows[3] = row3;
     }
 
+    /**
+     * @brief Constructor that initializes the matrix from a row-major array.
+     * @param m The elements of the matrix, m[row][column].
+     */
+    explicit mat4(const double (&m)[4][4]) {
+        for (int i = 0; i < 4; i++)
+            rows[i] = vec4(m[i][0], m[i][1], m[i][2], m[i][3]);
+    }
+
     /**
      * @brief Overloads the [] operator to access rows of the matrix.
      * @param i The index of the row to access.
@@ -55,8 +65,212 @@ class mat4 {
     const vec4& operator[](int i) const {
         return rows[i];
     }
+
+    /**
+     * @brief Returns one element of the matrix.
+     * @param row The row of the element.
+     * @param col The column of the element (3 is the w component of the row).
+     * @return The element.
+     */
+    double at(int row, int col) const {
+        return col < 3 ? rows[row][col] : rows[row].w;
+    }
+
+    /**
+     * @brief Returns the 4x4 identity matrix.
+     * @return The identity matrix.
+     */
+    static mat4 identity() {
+        return mat4(vec4(1, 0, 0, 0), vec4(0, 1, 0, 0), vec4(0, 0, 1, 0), vec4(0, 0, 0, 1));
+    }
+
+    /**
+     * @brief Returns an affine translation matrix.
+     * @param t The translation.
+     * @return The translation matrix.
+     */
+    static mat4 translation(const vec3& t) {
+        return mat4(vec4(1, 0, 0, t.x()), vec4(0, 1, 0, t.y()), vec4(0, 0, 1, t.z()), vec4(0, 0, 0, 1));
+    }
+
+    /**
+     * @brief Returns an affine scaling matrix.
+     * @param s The scale factor on each axis.
+     * @return The scaling matrix.
+     */
+    static mat4 scaling(const vec3& s) {
+        return mat4(vec4(s.x(), 0, 0, 0), vec4(0, s.y(), 0, 0), vec4(0, 0, s.z(), 0), vec4(0, 0, 0, 1));
+    }
+
+    /**
+     * @brief Returns a rotation matrix around an axis through the origin (Rodrigues' formula).
+     * @param axis The rotation axis (does not need to be normalized).
+     * @param radians The rotation angle, counterclockwise when looking against the axis.
+     * @return The rotation matrix.
+     */
+    static mat4 rotation(const vec3& axis, double radians) {
+        vec3 a = unit_vector(axis);
+        double c = std::cos(radians), s = std::sin(radians), k = 1 - c;
+        double x = a.x(), y = a.y(), z = a.z();
+        return mat4(vec4(c + x*x*k,   x*y*k - z*s, x*z*k + y*s, 0),
+                    vec4(y*x*k + z*s, c + y*y*k,   y*z*k - x*s, 0),
+                    vec4(z*x*k - y*s, z*y*k + x*s, c + z*z*k,   0),
+                    vec4(0, 0, 0, 1));
+    }
+
+    /**
+     * @brief Calculates the transpose of the matrix.
+     * @return The transposed matrix.
+     */
+    mat4 transpose() const {
+        double m[4][4];
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                m[i][j] = at(j, i);
+        return mat4(m);
+    }
+
+    /**
+     * @brief Returns the upper-left 3x3 block (the linear part of an affine transform).
+     * @return The 3x3 block.
+     */
+    mat3 upper_left() const {
+        return mat3(rows[0], rows[1], rows[2]);
+    }
+
+    /**
+     * @brief Calculates the determinant of the matrix.
+     * @return The determinant of the matrix.
+     */
+    double determinant() const {
+        double s[6], c[6];
+        minors(s, c);
+        return s[0]*c[5] - s[1]*c[4] + s[2]*c[3] + s[3]*c[2] - s[4]*c[1] + s[5]*c[0];
+    }
+
+    /**
+     * @brief Calculates the inverse of the matrix (adjugate divided by the determinant).
+     * @pre The matrix is invertible (non-zero determinant).
+     * @return The inverse of the matrix.
+     */
+    mat4 inverse() const {
+        double s[6], c[6];
+        minors(s, c);
+        double inv_det = 1 / (s[0]*c[5] - s[1]*c[4] + s[2]*c[3] + s[3]*c[2] - s[4]*c[1] + s[5]*c[0]);
+
+        auto a = [this](int i, int j) { return at(i, j); };
+        double m[4][4] = {
+            { a(1,1)*c[5] - a(1,2)*c[4] + a(1,3)*c[3], -a(0,1)*c[5] + a(0,2)*c[4] - a(0,3)*c[3],
+              a(3,1)*s[5] - a(3,2)*s[4] + a(3,3)*s[3], -a(2,1)*s[5] + a(2,2)*s[4] - a(2,3)*s[3] },
+            {-a(1,0)*c[5] + a(1,2)*c[2] - a(1,3)*c[1],  a(0,0)*c[5] - a(0,2)*c[2] + a(0,3)*c[1],
+             -a(3,0)*s[5] + a(3,2)*s[2] - a(3,3)*s[1],  a(2,0)*s[5] - a(2,2)*s[2] + a(2,3)*s[1] },
+            { a(1,0)*c[4] - a(1,1)*c[2] + a(1,3)*c[0], -a(0,0)*c[4] + a(0,1)*c[2] - a(0,3)*c[0],
+              a(3,0)*s[4] - a(3,1)*s[2] + a(3,3)*s[0], -a(2,0)*s[4] + a(2,1)*s[2] - a(2,3)*s[0] },
+            {-a(1,0)*c[3] + a(1,1)*c[1] - a(1,2)*c[0],  a(0,0)*c[3] - a(0,1)*c[1] + a(0,2)*c[0],
+             -a(3,0)*s[3] + a(3,1)*s[1] - a(3,2)*s[0],  a(2,0)*s[3] - a(2,1)*s[1] + a(2,2)*s[0] }
+        };
+        for (auto& row : m)
+            for (double& value : row)
+                value *= inv_det;
+        return mat4(m);
+    }
+
+  private:
+    /**
+     * @brief Calculates the 2x2 minors of the top two rows (s) and of the bottom two rows (c).
+     *
+     * The determinant and the adjugate are both sums of products s[i] * c[5 - i] (Laplace
+     * expansion along the top two rows), so they share these 12 minors.
+     */
+    void minors(double (&s)[6], double (&c)[6]) const {
+        s[0] = at(0,0)*at(1,1) - at(1,0)*at(0,1);
+        s[1] = at(0,0)*at(1,2) - at(1,0)*at(0,2);
+        s[2] = at(0,0)*at(1,3) - at(1,0)*at(0,3);
+        s[3] = at(0,1)*at(1,2) - at(1,1)*at(0,2);
+        s[4] = at(0,1)*at(1,3) - at(1,1)*at(0,3);
+        s[5] = at(0,2)*at(1,3) - at(1,2)*at(0,3);
+
+        c[0] = at(2,0)*at(3,1) - at(3,0)*at(2,1);
+        c[1] = at(2,0)*at(3,2) - at(3,0)*at(2,2);
+        c[2] = at(2,0)*at(3,3) - at(3,0)*at(2,3);
+        c[3] = at(2,1)*at(3,2) - at(3,1)*at(2,2);
+        c[4] = at(2,1)*at(3,3) - at(3,1)*at(2,3);
+        c[5] = at(2,2)*at(3,3) - at(3,2)*at(2,3);
+    }
 };
 
+/**
+ * @brief Overloads the * operator to multiply two matrices.
+ *
+ * Each entry is the dot product of a row of a and a column of b, accumulated in double. The rows
+ * are vec4 (a vec3 plus w), which has no arithmetic of its own, so the product is computed
+ * entry by entry instead of as combinations of rows like mat3.
+ *
+ * @param a The left matrix.
+ * @param b The right matrix.
+ * @return The product a * b.
+ */
+inline mat4 operator*(const mat4& a, const mat4& b) {
+    double m[4][4];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            double sum = 0;
+            for (int k = 0; k < 4; k++)
+                sum += a.at(i, k) * b.at(k, j);
+            m[i][j] = sum;
+        }
+    }
+    return mat4(m);
+}
+
+/**
+ * @brief Overloads the * operator to multiply a matrix by a homogeneous column vector.
+ * @param m The matrix.
+ * @param v The vector (with its w component).
+ * @return The product m * v.
+ */
+inline vec4 operator*(const mat4& m, const vec4& v) {
+    double r[4];
+    for (int i = 0; i < 4; i++)
+        r[i] = m.at(i, 0) * v.x() + m.at(i, 1) * v.y() + m.at(i, 2) * v.z() + m.at(i, 3) * v.w;
+    return vec4(r[0], r[1], r[2], r[3]);
+}
+
+/**
+ * @brief Transforms a point (w = 1), dividing by the resulting w for projective matrices.
+ * @param m The transform.
+ * @param p The point.
+ * @return The transformed point.
+ */
+inline point3 transform_point(const mat4& m, const point3& p) {
+    vec4 r = m * vec4(p.x(), p.y(), p.z(), 1);
+    if (r.w == 1)
+        return point3(r.x(), r.y(), r.z());
+    return point3(r.x() / r.w, r.y() / r.w, r.z() / r.w);
+}
+
+/**
+ * @brief Transforms a direction (w = 0), ignoring the translation.
+ * @param m The transform.
+ * @param v The direction.
+ * @return The transformed direction.
+ */
+inline vec3 transform_vector(const mat4& m, const vec3& v) {
+    return m.upper_left() * v;
+}
+
+/**
+ * @brief Calculates the matrix that transforms normals: the inverse transpose of the linear part.
+ *
+ * Transformed normals must be normalized again unless the transform is a rotation.
+ *
+ * @param m The transform applied to points.
+ * @return The normal matrix.
+ */
+inline mat3 normal_matrix(const mat4& m) {
+    return m.upper_left().inverse_transpose();
+}
+
 /**
  * @brief Overloads the << operator to print the matrix.
  * @param out The output stream to print to.
@@ -0,0 +1,269 @@
+/**
+ * @file transform.h
+ * @brief Batch transforms of points and normals stored as contiguous xyz float arrays.
+ * @author Martin Henrique Viana Adam
+ *
+ * Meshes keep their vertices as packed `float` triples (x0 y0 z0 x1 y1 z1 ...). These functions
+ * transform a whole array at once: the matrix is converted to float a single time and the points
+ * are processed 4 at a time with SSE (8 at a time with AVX when compiled with `-mavx` or
+ * `-march=native`), transposed to x, y and z registers in place, so that the loop is limited by
+ * memory bandwidth rather than by arithmetic. Every lane performs the same float operations, in
+ * the same order, as the scalar tail, so the result does not depend on the instruction set.
+ */
+
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "mat3.h"
+#include "mat4.h"
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define TRANSFORM_SSE 1
+#else
+#define TRANSFORM_SSE 0
+#endif
+
+namespace transform_detail {
+
+/**
+ * @brief Coefficients of an affine 3x4 transform, converted to float.
+ */
+struct affine_f {
+    float m[3][4];
+
+    explicit affine_f(const mat4& t) {
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 4; j++)
+                m[i][j] = static_cast<float>(t.at(i, j));
+    }
+
+    explicit affine_f(const mat3& t) {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++)
+                m[i][j] = static_cast<float>(t[i][j]);
+            m[i][3] = 0.0f;
+        }
+    }
+};
+
+/**
+ * @brief Transforms one point (or, with a zero translation, one direction) with scalar math.
+ */
+inline void transform_one(const affine_f& a, const float* in, float* out, bool translate) {
+    float x = in[0], y = in[1], z = in[2];
+    for (int i = 0; i < 3; i++) {
+        float r = a.m[i][0] * x + a.m[i][1] * y + a.m[i][2] * z;
+        out[i] = translate ? r + a.m[i][3] : r;
+    }
+}
+
+/**
+ * @brief Normalizes one vector with the same operations as the SIMD kernels.
+ */
+inline void normalize_one(float* v) {
+    float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    v[0] = v[0] / length;
+    v[1] = v[1] / length;
+    v[2] = v[2] / length;
+}
+
+#if TRANSFORM_SSE
+/**
+ * @brief Transposes 4 packed xyz triples (3 registers) into x, y and z registers.
+ */
+inline void soa_from_xyz(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z) {
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+    __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+    x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+/**
+ * @brief Transposes x, y and z registers back into 4 packed xyz triples.
+ */
+inline void xyz_from_soa(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c) {
+    __m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0)); // x0 x1 y0 y1
+    __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)); // z0 z0 x1 x1
+    __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)); // y1 y1 z1 z1
+    __m128 xy2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)); // x2 x2 y2 y2
+    __m128 zx3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)); // z2 z2 x3 x3
+    __m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+    a = _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+    b = _mm_shuffle_ps(yz, xy2, _MM_SHUFFLE(2, 0, 2, 0));
+    c = _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/**
+ * @brief Transforms 4 points (or directions) at a time with SSE.
+ * @return The number of points processed (a multiple of 4).
+ */
+inline size_t transform_sse(const affine_f& t, const float* in, float* out, size_t count,
+                            bool translate, bool normalize) {
+    __m128 m[3][4];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            m[i][j] = _mm_set1_ps(t.m[i][j]);
+
+    size_t n = 0;
+    for (; n + 4 <= count; n += 4) {
+        const float* p = in + 3 * n;
+        __m128 x, y, z;
+        soa_from_xyz(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), x, y, z);
+
+        __m128 r[3];
+        for (int i = 0; i < 3; i++) {
+            r[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[i][0], x), _mm_mul_ps(m[i][1], y)), _mm_mul_ps(m[i][2], z));
+            if (translate)
+                r[i] = _mm_add_ps(r[i], m[i][3]);
+        }
+        if (normalize) {
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], r[0]), _mm_mul_ps(r[1], r[1])),
+                                                   _mm_mul_ps(r[2], r[2])));
+            for (__m128& c : r)
+                c = _mm_div_ps(c, length);
+        }
+
+        __m128 a, b, c;
+        xyz_from_soa(r[0], r[1], r[2], a, b, c);
+        float* q = out + 3 * n;
+        _mm_storeu_ps(q, a);
+        _mm_storeu_ps(q + 4, b);
+        _mm_storeu_ps(q + 8, c);
+    }
+    return n;
+}
+#endif
+
+#if defined(__AVX__)
+/**
+ * @brief Transforms 8 points (or directions) at a time with AVX.
+ *
+ * Each 128-bit half of the registers holds 4 consecutive points, so the SSE transposes apply
+ * unchanged to both halves.
+ *
+ * @return The number of points processed (a multiple of 8).
+ */
+inline size_t transform_avx(const affine_f& t, const float* in, float* out, size_t count,
+                            bool translate, bool normalize) {
+    __m256 m[3][4];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            m[i][j] = _mm256_set1_ps(t.m[i][j]);
+
+    auto load = [](const float* lo, const float* hi) {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+    };
+
+    size_t n = 0;
+    for (; n + 8 <= count; n += 8) {
+        const float* p = in + 3 * n;
+        __m256 a = load(p, p + 12), b = load(p + 4, p + 16), c = load(p + 8, p + 20);
+        __m256 t0 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+        __m256 t1 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+        __m256 x = _mm256_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+        __m256 y = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+        __m256 z = _mm256_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));
+
+        __m256 r[3];
+        for (int i = 0; i < 3; i++) {
+            r[i] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[i][0], x), _mm256_mul_ps(m[i][1], y)),
+                                 _mm256_mul_ps(m[i][2], z));
+            if (translate)
+                r[i] = _mm256_add_ps(r[i], m[i][3]);
+        }
+        if (normalize) {
+            __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], r[0]),
+                                                                       _mm256_mul_ps(r[1], r[1])),
+                                                         _mm256_mul_ps(r[2], r[2])));
+            for (__m256& v : r)
+                v = _mm256_div_ps(v, length);
+        }
+
+        __m256 xy = _mm256_shuffle_ps(r[0], r[1], _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 zx = _mm256_shuffle_ps(r[2], r[0], _MM_SHUFFLE(1, 1, 0, 0));
+        __m256 yz = _mm256_shuffle_ps(r[1], r[2], _MM_SHUFFLE(1, 1, 1, 1));
+        __m256 xy2 = _mm256_shuffle_ps(r[0], r[1], _MM_SHUFFLE(2, 2, 2, 2));
+        __m256 zx3 = _mm256_shuffle_ps(r[2], r[0], _MM_SHUFFLE(3, 3, 2, 2));
+        __m256 yz3 = _mm256_shuffle_ps(r[1], r[2], _MM_SHUFFLE(3, 3, 3, 3));
+        a = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+        b = _mm256_shuffle_ps(yz, xy2, _MM_SHUFFLE(2, 0, 2, 0));
+        c = _mm256_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 0, 2, 0));
+
+        float* q = out + 3 * n;
+        _mm_storeu_ps(q, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(q + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(q + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(q + 12, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(q + 16, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(q + 20, _mm256_extractf128_ps(c, 1));
+    }
+    return n;
+}
+#endif
+
+/**
+ * @brief Transforms an array with the widest kernel available, then finishes it with scalar math.
+ */
+inline void transform_array(const affine_f& t, const float* in, float* out, size_t count,
+                            bool translate, bool normalize) {
+    size_t n = 0;
+#if defined(__AVX__)
+    n = transform_avx(t, in, out, count, translate, normalize);
+#endif
+#if TRANSFORM_SSE
+    n += transform_sse(t, in + 3 * n, out + 3 * n, count - n, translate, normalize);
+#endif
+    for (; n < count; n++) {
+        transform_one(t, in + 3 * n, out + 3 * n, translate);
+        if (normalize)
+            normalize_one(out + 3 * n);
+    }
+}
+
+} // namespace transform_detail
+
+/**
+ * @brief Transforms an array of points stored as packed xyz floats.
+ *
+ * Only the affine part of the matrix (the top three rows) is used.
+ *
+ * @param m The affine transform.
+ * @param in The input points (3 * count floats).
+ * @param out The output points (3 * count floats); may be the same array as `in`.
+ * @param count The number of points.
+ */
+inline void transform_points(const mat4& m, const float* in, float* out, size_t count) {
+    transform_detail::transform_array(transform_detail::affine_f(m), in, out, count, true, false);
+}
+
+/**
+ * @brief Transforms an array of directions stored as packed xyz floats (no translation).
+ *
+ * @param m The affine transform.
+ * @param in The input directions (3 * count floats).
+ * @param out The output directions (3 * count floats); may be the same array as `in`.
+ * @param count The number of directions.
+ */
+inline void transform_vectors(const mat4& m, const float* in, float* out, size_t count) {
+    transform_detail::transform_array(transform_detail::affine_f(m), in, out, count, false, false);
+}
+
+/**
+ * @brief Transforms an array of normals stored as packed xyz floats and normalizes them.
+ *
+ * @param normal_m The normal matrix, usually `normal_matrix(m)` for the transform m of the points.
+ * @param in The input normals (3 * count floats).
+ * @param out The output unit normals (3 * count floats); may be the same array as `in`.
+ * @param count The number of normals.
+ */
+inline void transform_normals(const mat3& normal_m, const float* in, float* out, size_t count) {
+    transform_detail::transform_array(transform_detail::affine_f(normal_m), in, out, count, false, true);
+}
+
+#endif
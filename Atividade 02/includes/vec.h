@@ -0,0 +1,330 @@
+/**
+ * @file vec.h
+ * @brief Defines the vec<T, N> class template and related functions.
+ * @author Martin Henrique Viana Adam
+ *
+ * Every operation is defined in this header (and is `constexpr` where the standard library allows
+ * it), so the compiler can inline `dot`, `cross` and the arithmetic operators into the
+ * intersection loops of any translation unit that includes it.
+ */
+
+#ifndef VEC_H
+#define VEC_H
+
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+
+/**
+ * @class vec
+ * @brief A class template that represents an N-dimensional vector with components of type T.
+ * @tparam T The component type (float or double).
+ * @tparam N The number of components.
+ */
+template <typename T, int N>
+class vec {
+    static_assert(std::is_floating_point<T>::value, "vec components must be float or double");
+    static_assert(N > 0, "vec must have at least one component");
+
+  public:
+    using value_type = T;               ///< The component type.
+    static constexpr int dimension = N; ///< The number of components.
+
+    T e[N];
+
+    /**
+     * @brief Default constructor. Initializes the vector to zero.
+     */
+    constexpr vec() : e{} {}
+
+    /**
+     * @brief Constructor that initializes the vector with N components.
+     * @param args The components of the vector, converted to T.
+     */
+    template <typename... Args,
+              typename = std::enable_if_t<sizeof...(Args) == N &&
+                                          std::conjunction<std::is_arithmetic<Args>...>::value>>
+    constexpr vec(Args... args) : e{static_cast<T>(args)...} {}
+
+    /**
+     * @brief Converts a vector with another component type (for example, double to float).
+     * @param v The vector to convert.
+     */
+    template <typename U, typename = std::enable_if_t<!std::is_same<U, T>::value>>
+    constexpr explicit vec(const vec<U, N> &v) : e{} {
+        for (int i = 0; i < N; i++)
+            e[i] = static_cast<T>(v.e[i]);
+    }
+
+    /**
+     * @brief Getter for the x component of the vector.
+     * @return The x component of the vector.
+     */
+    constexpr T x() const { return e[0]; }
+
+    /**
+     * @brief Getter for the y component of the vector.
+     * @return The y component of the vector.
+     */
+    constexpr T y() const {
+        static_assert(N >= 2, "vec has no y component");
+        return e[1];
+    }
+
+    /**
+     * @brief Getter for the z component of the vector.
+     * @return The z component of the vector.
+     */
+    constexpr T z() const {
+        static_assert(N >= 3, "vec has no z component");
+        return e[2];
+    }
+
+    /**
+     * @brief Overloads the unary minus operator to return the negation of the vector.
+     * @return A new vector that is the negation of the current object.
+     */
+    constexpr vec operator-() const {
+        vec r;
+        for (int i = 0; i < N; i++)
+            r.e[i] = -e[i];
+        return r;
+    }
+
+    /**
+     * @brief Overloads the [] operator to access components of the vector.
+     * @param i The index of the component to access.
+     * @return The i-th component of the vector.
+     */
+    constexpr T operator[](int i) const { return e[i]; }
+
+    /**
+     * @brief Overloads the [] operator to access components of the vector.
+     * @param i The index of the component to access.
+     * @return A reference to the i-th component of the vector.
+     */
+    constexpr T& operator[](int i) { return e[i]; }
+
+    /**
+     * @brief Overloads the += operator to add another vector to this vector.
+     * @param v The other vector.
+     * @return A reference to the current object.
+     */
+    constexpr vec& operator+=(const vec &v) {
+        for (int i = 0; i < N; i++)
+            e[i] += v.e[i];
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the -= operator to subtract another vector from this vector.
+     * @param v The other vector.
+     * @return A reference to the current object.
+     */
+    constexpr vec& operator-=(const vec &v) {
+        for (int i = 0; i < N; i++)
+            e[i] -= v.e[i];
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the *= operator to multiply this vector by a scalar.
+     * @param t The scalar.
+     * @return A reference to the current object.
+     */
+    constexpr vec& operator*=(T t) {
+        for (int i = 0; i < N; i++)
+            e[i] *= t;
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the /= operator to divide this vector by a scalar.
+     * @param t The scalar.
+     * @return A reference to the current object.
+     */
+    constexpr vec& operator/=(T t) {
+        return *this *= 1/t;
+    }
+
+    /**
+     * @brief Calculates the length of the vector.
+     * @return The length of the vector.
+     */
+    T length() const {
+        return std::sqrt(length_squared());
+    }
+
+    /**
+     * @brief Calculates the squared length of the vector.
+     * @return The squared length of the vector.
+     */
+    constexpr T length_squared() const {
+        T s = e[0]*e[0];
+        for (int i = 1; i < N; i++)
+            s += e[i]*e[i];
+        return s;
+    }
+
+    /**
+     * @brief Check if the vector is near zero.
+     *
+     * @return true if the vector is near zero, false otherwise.
+     */
+    bool near_zero() const {
+        const T s = static_cast<T>(1e-8);
+        for (int i = 0; i < N; i++)
+            if (!(std::fabs(e[i]) < s))
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief Generate a random vector with components in the specified range.
+     *
+     * Uses `random_double(min, max)`, which must be declared before this header is included.
+     *
+     * @param min The minimum value for each component.
+     * @param max The maximum value for each component.
+     * @return A random vector with components in the specified range.
+     */
+    static vec random(T min, T max) {
+        vec r;
+        for (int i = 0; i < N; i++)
+            r.e[i] = static_cast<T>(random_double(min, max));
+        return r;
+    }
+};
+
+// Vector Utility Functions
+
+/**
+ * @brief Overloads the << operator to print the vector.
+ * @param out The output stream to print to.
+ * @param v The vector to print.
+ * @return The output stream.
+ */
+template <typename T, int N>
+std::ostream& operator<<(std::ostream &out, const vec<T, N> &v) {
+    out << v.e[0];
+    for (int i = 1; i < N; i++)
+        out << ' ' << v.e[i];
+    return out;
+}
+
+/**
+ * @brief Overloads the + operator to add two vectors.
+ * @param u The first vector.
+ * @param v The second vector.
+ * @return The sum of the two vectors.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator+(const vec<T, N> &u, const vec<T, N> &v) {
+    vec<T, N> r;
+    for (int i = 0; i < N; i++)
+        r.e[i] = u.e[i] + v.e[i];
+    return r;
+}
+
+/**
+ * @brief Overloads the - operator to subtract two vectors.
+ * @param u The first vector.
+ * @param v The second vector.
+ * @return The difference of the two vectors.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator-(const vec<T, N> &u, const vec<T, N> &v) {
+    vec<T, N> r;
+    for (int i = 0; i < N; i++)
+        r.e[i] = u.e[i] - v.e[i];
+    return r;
+}
+
+/**
+ * @brief Overloads the * operator to multiply two vectors component-wise.
+ * @param u The first vector.
+ * @param v The second vector.
+ * @return The component-wise product of the two vectors.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator*(const vec<T, N> &u, const vec<T, N> &v) {
+    vec<T, N> r;
+    for (int i = 0; i < N; i++)
+        r.e[i] = u.e[i] * v.e[i];
+    return r;
+}
+
+/**
+ * @brief Overloads the * operator to multiply a vector by a scalar.
+ * @param t The scalar (not used to deduce T, so integer literals are accepted).
+ * @param v The vector.
+ * @return The product of the scalar and the vector.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator*(typename vec<T, N>::value_type t, const vec<T, N> &v) {
+    vec<T, N> r;
+    for (int i = 0; i < N; i++)
+        r.e[i] = t*v.e[i];
+    return r;
+}
+
+/**
+ * @brief Overloads the * operator to multiply a vector by a scalar.
+ * @param v The vector.
+ * @param t The scalar.
+ * @return The product of the scalar and the vector.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator*(const vec<T, N> &v, typename vec<T, N>::value_type t) {
+    return t * v;
+}
+
+/**
+ * @brief Overloads the / operator to divide a vector by a scalar.
+ * @param v The vector.
+ * @param t The scalar.
+ * @return The quotient of the vector and the scalar.
+ */
+template <typename T, int N>
+constexpr vec<T, N> operator/(const vec<T, N> &v, typename vec<T, N>::value_type t) {
+    return (1/t) * v;
+}
+
+/**
+ * @brief Calculates the dot product of two vectors.
+ * @param u The first vector.
+ * @param v The second vector.
+ * @return The dot product of the two vectors.
+ */
+template <typename T, int N>
+constexpr T dot(const vec<T, N> &u, const vec<T, N> &v) {
+    T s = u.e[0] * v.e[0];
+    for (int i = 1; i < N; i++)
+        s += u.e[i] * v.e[i];
+    return s;
+}
+
+/**
+ * @brief Calculates the cross product of two 3D vectors.
+ * @param u The first vector.
+ * @param v The second vector.
+ * @return The cross product of the two vectors.
+ */
+template <typename T>
+constexpr vec<T, 3> cross(const vec<T, 3> &u, const vec<T, 3> &v) {
+    return vec<T, 3>(u.e[1] * v.e[2] - u.e[2] * v.e[1],
+                     u.e[2] * v.e[0] - u.e[0] * v.e[2],
+                     u.e[0] * v.e[1] - u.e[1] * v.e[0]);
+}
+
+/**
+ * @brief Calculates the unit vector of a vector.
+ * @param v The vector.
+ * @return The unit vector of the vector.
+ */
+template <typename T, int N>
+vec<T, N> unit_vector(const vec<T, N> &v) {
+    return v / v.length();
+}
+
+#endif
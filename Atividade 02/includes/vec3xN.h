@@ -0,0 +1,648 @@
+/**
+ * @file vec3xN.h
+ * @brief Defines packets of W 3D vectors stored as structure of arrays (vec3xN<T, W>).
+ * @author Martin Henrique Viana Adam
+ *
+ * A vec3 stores x, y and z next to each other, so a loop over many vectors cannot put one vector
+ * per SIMD lane. vec3xN keeps W vectors as three arrays (all x, all y, all z): the arithmetic
+ * operations are fixed-length loops over the lanes, which the compiler turns into a single SSE or
+ * AVX instruction per component (W = 4 for SSE float, W = 8 for AVX float). `sqrt` uses the SSE/AVX
+ * square root instructions directly, since `std::sqrt` is not vectorized while it may set errno.
+ * Comparisons produce a
+ * packet_mask and `select` picks lanes without branches, so an intersection or shading kernel can
+ * be written once, as with vec3, and run W lanes wide.
+ */
+
+#ifndef VEC3XN_H
+#define VEC3XN_H
+
+#include "vec3.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define VEC3XN_SSE 1
+#else
+#define VEC3XN_SSE 0
+#endif
+
+namespace vec3xN_detail {
+
+/**
+ * @brief The smallest power of two that is not less than n, used to align packets of any width.
+ */
+constexpr size_t alignment_for(size_t n, size_t p = 1) {
+    return p >= n ? p : alignment_for(n, 2 * p);
+}
+
+/**
+ * @brief Square root of n floats, 8 (AVX) or 4 (SSE) at a time.
+ */
+inline void sqrt_lanes(const float *a, float *r, int n) {
+    int i = 0;
+#if defined(__AVX__)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(r + i, _mm256_sqrt_ps(_mm256_loadu_ps(a + i)));
+#endif
+#if VEC3XN_SSE
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(r + i, _mm_sqrt_ps(_mm_loadu_ps(a + i)));
+#endif
+    for (; i < n; i++)
+        r[i] = std::sqrt(a[i]);
+}
+
+/**
+ * @brief Square root of n doubles, 4 (AVX) or 2 (SSE2) at a time.
+ */
+inline void sqrt_lanes(const double *a, double *r, int n) {
+    int i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(r + i, _mm256_sqrt_pd(_mm256_loadu_pd(a + i)));
+#endif
+#if VEC3XN_SSE
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(r + i, _mm_sqrt_pd(_mm_loadu_pd(a + i)));
+#endif
+    for (; i < n; i++)
+        r[i] = std::sqrt(a[i]);
+}
+
+} // namespace vec3xN_detail
+
+/**
+ * @class packet_mask
+ * @brief The result of comparing two packets: each lane is all ones (true) or zero (false).
+ *
+ * The lanes have the same width as T, so that `select` is a bitwise blend of the two packets.
+ * @tparam T The component type of the compared packets.
+ * @tparam W The number of lanes.
+ */
+template <typename T, int W>
+struct packet_mask {
+    using bits = typename std::conditional<sizeof(T) == 4, int32_t, int64_t>::type;
+
+    alignas(vec3xN_detail::alignment_for(sizeof(T) * W)) bits m[W];
+
+    /**
+     * @brief Default constructor. All lanes are false.
+     */
+    constexpr packet_mask() : m{} {}
+
+    /**
+     * @brief Constructor that sets every lane to the same value.
+     * @param b The value of every lane.
+     */
+    constexpr explicit packet_mask(bool b) : m{} {
+        for (int i = 0; i < W; i++)
+            m[i] = b ? bits(-1) : bits(0);
+    }
+
+    /**
+     * @brief Getter for one lane.
+     * @param i The lane.
+     * @return true if the lane is set.
+     */
+    constexpr bool operator[](int i) const { return m[i] != 0; }
+
+    /**
+     * @brief Sets one lane.
+     * @param i The lane.
+     * @param b The new value of the lane.
+     */
+    constexpr void set(int i, bool b) { m[i] = b ? bits(-1) : bits(0); }
+
+    /**
+     * @brief Packs the lanes into an integer, lane i in bit i.
+     * @return The lane bits.
+     */
+    constexpr unsigned to_bits() const {
+        unsigned r = 0;
+        for (int i = 0; i < W; i++)
+            r |= (m[i] != 0 ? 1u : 0u) << i;
+        return r;
+    }
+};
+
+/**
+ * @brief Lane-wise and of two masks.
+ */
+template <typename T, int W>
+constexpr packet_mask<T, W> operator&(const packet_mask<T, W> &a, const packet_mask<T, W> &b) {
+    packet_mask<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.m[i] = a.m[i] & b.m[i];
+    return r;
+}
+
+/**
+ * @brief Lane-wise or of two masks.
+ */
+template <typename T, int W>
+constexpr packet_mask<T, W> operator|(const packet_mask<T, W> &a, const packet_mask<T, W> &b) {
+    packet_mask<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.m[i] = a.m[i] | b.m[i];
+    return r;
+}
+
+/**
+ * @brief Lane-wise negation of a mask.
+ */
+template <typename T, int W>
+constexpr packet_mask<T, W> operator!(const packet_mask<T, W> &a) {
+    packet_mask<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.m[i] = ~a.m[i];
+    return r;
+}
+
+/**
+ * @brief Checks whether any lane of the mask is set.
+ */
+template <typename T, int W>
+constexpr bool any(const packet_mask<T, W> &a) { return a.to_bits() != 0; }
+
+/**
+ * @brief Checks whether every lane of the mask is set.
+ */
+template <typename T, int W>
+constexpr bool all(const packet_mask<T, W> &a) { return a.to_bits() == (1u << W) - 1; }
+
+/**
+ * @brief Checks whether no lane of the mask is set.
+ */
+template <typename T, int W>
+constexpr bool none(const packet_mask<T, W> &a) { return a.to_bits() == 0; }
+
+/**
+ * @class packet
+ * @brief W scalars of type T, one per lane.
+ * @tparam T The component type (float or double).
+ * @tparam W The number of lanes.
+ */
+template <typename T, int W>
+struct packet {
+    static_assert(std::is_floating_point<T>::value, "packet lanes must be float or double");
+    static_assert(W > 0 && W <= 16, "packet must have between 1 and 16 lanes");
+
+    using value_type = T;           ///< The lane type.
+    static constexpr int width = W; ///< The number of lanes.
+
+    alignas(vec3xN_detail::alignment_for(sizeof(T) * W)) T v[W];
+
+    /**
+     * @brief Default constructor. Initializes every lane to zero.
+     */
+    constexpr packet() : v{} {}
+
+    /**
+     * @brief Constructor that broadcasts a scalar to every lane.
+     * @param t The value of every lane.
+     */
+    constexpr packet(T t) : v{} {
+        for (int i = 0; i < W; i++)
+            v[i] = t;
+    }
+
+    /**
+     * @brief Loads W consecutive scalars.
+     * @param p Pointer to the first scalar.
+     * @return The packet.
+     */
+    static constexpr packet load(const T* p) {
+        packet r;
+        for (int i = 0; i < W; i++)
+            r.v[i] = p[i];
+        return r;
+    }
+
+    /**
+     * @brief Stores the lanes to W consecutive scalars.
+     * @param p Pointer to the first scalar.
+     */
+    constexpr void store(T* p) const {
+        for (int i = 0; i < W; i++)
+            p[i] = v[i];
+    }
+
+    /**
+     * @brief Overloads the [] operator to access one lane.
+     */
+    constexpr T operator[](int i) const { return v[i]; }
+
+    /**
+     * @brief Overloads the [] operator to access one lane.
+     */
+    constexpr T& operator[](int i) { return v[i]; }
+};
+
+/// Defines a lane-wise binary operator of two packets.
+#define VEC3XN_PACKET_BINARY(op)                                                              \
+    template <typename T, int W>                                                              \
+    constexpr packet<T, W> operator op(const packet<T, W> &a, const packet<T, W> &b) {        \
+        packet<T, W> r;                                                                       \
+        for (int i = 0; i < W; i++)                                                           \
+            r.v[i] = a.v[i] op b.v[i];                                                        \
+        return r;                                                                             \
+    }
+
+VEC3XN_PACKET_BINARY(+)
+VEC3XN_PACKET_BINARY(-)
+VEC3XN_PACKET_BINARY(*)
+VEC3XN_PACKET_BINARY(/)
+#undef VEC3XN_PACKET_BINARY
+
+/// Defines a lane-wise comparison of two packets.
+#define VEC3XN_PACKET_COMPARE(op)                                                             \
+    template <typename T, int W>                                                              \
+    constexpr packet_mask<T, W> operator op(const packet<T, W> &a, const packet<T, W> &b) {   \
+        packet_mask<T, W> r;                                                                  \
+        for (int i = 0; i < W; i++)                                                           \
+            r.m[i] = a.v[i] op b.v[i] ? -1 : 0;                                               \
+        return r;                                                                             \
+    }
+
+VEC3XN_PACKET_COMPARE(<)
+VEC3XN_PACKET_COMPARE(<=)
+VEC3XN_PACKET_COMPARE(>)
+VEC3XN_PACKET_COMPARE(>=)
+VEC3XN_PACKET_COMPARE(==)
+VEC3XN_PACKET_COMPARE(!=)
+#undef VEC3XN_PACKET_COMPARE
+
+/**
+ * @brief Lane-wise negation of a packet.
+ */
+template <typename T, int W>
+constexpr packet<T, W> operator-(const packet<T, W> &a) {
+    packet<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.v[i] = -a.v[i];
+    return r;
+}
+
+/**
+ * @brief Lane-wise square root of a packet.
+ */
+template <typename T, int W>
+packet<T, W> sqrt(const packet<T, W> &a) {
+    packet<T, W> r;
+    vec3xN_detail::sqrt_lanes(a.v, r.v, W);
+    return r;
+}
+
+/**
+ * @brief Lane-wise minimum of two packets.
+ */
+template <typename T, int W>
+constexpr packet<T, W> min(const packet<T, W> &a, const packet<T, W> &b) {
+    packet<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+    return r;
+}
+
+/**
+ * @brief Lane-wise maximum of two packets.
+ */
+template <typename T, int W>
+constexpr packet<T, W> max(const packet<T, W> &a, const packet<T, W> &b) {
+    packet<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+    return r;
+}
+
+/**
+ * @brief Picks each lane from `a` where the mask is set and from `b` elsewhere.
+ * @param m The mask.
+ * @param a The lanes used where the mask is set.
+ * @param b The lanes used where the mask is not set.
+ * @return The blended packet.
+ */
+template <typename T, int W>
+constexpr packet<T, W> select(const packet_mask<T, W> &m, const packet<T, W> &a, const packet<T, W> &b) {
+    packet<T, W> r;
+    for (int i = 0; i < W; i++)
+        r.v[i] = m.m[i] ? a.v[i] : b.v[i];
+    return r;
+}
+
+/**
+ * @class vec3xN
+ * @brief W 3D vectors stored as structure of arrays: one packet per component.
+ * @tparam T The component type (float or double).
+ * @tparam W The number of lanes.
+ */
+template <typename T, int W>
+class vec3xN {
+  public:
+    using value_type = T;             ///< The component type.
+    using scalar = packet<T, W>;      ///< A packet of W scalars, returned by dot and length.
+    using mask = packet_mask<T, W>;   ///< The result of comparing two scalar packets.
+    static constexpr int width = W;   ///< The number of lanes.
+
+    scalar e[3];
+
+    /**
+     * @brief Default constructor. Initializes every lane to the zero vector.
+     */
+    constexpr vec3xN() : e{} {}
+
+    /**
+     * @brief Constructor from one packet per component.
+     * @param x The x components.
+     * @param y The y components.
+     * @param z The z components.
+     */
+    constexpr vec3xN(const scalar &x, const scalar &y, const scalar &z) : e{x, y, z} {}
+
+    /**
+     * @brief Constructor that broadcasts one vector to every lane.
+     * @param v The vector.
+     */
+    constexpr explicit vec3xN(const vec<T, 3> &v) : e{scalar(v.e[0]), scalar(v.e[1]), scalar(v.e[2])} {}
+
+    /**
+     * @brief Loads W vectors stored as structure of arrays.
+     * @param x Pointer to W consecutive x components.
+     * @param y Pointer to W consecutive y components.
+     * @param z Pointer to W consecutive z components.
+     * @return The packet.
+     */
+    static constexpr vec3xN load(const T* x, const T* y, const T* z) {
+        return vec3xN(scalar::load(x), scalar::load(y), scalar::load(z));
+    }
+
+    /**
+     * @brief Loads W consecutive vectors (array of structures).
+     * @param v Pointer to the first vector.
+     * @return The packet.
+     */
+    static constexpr vec3xN load(const vec<T, 3>* v) {
+        vec3xN r;
+        for (int i = 0; i < W; i++)
+            r.set(i, v[i]);
+        return r;
+    }
+
+    /**
+     * @brief Stores the lanes as structure of arrays.
+     * @param x Pointer to W consecutive x components.
+     * @param y Pointer to W consecutive y components.
+     * @param z Pointer to W consecutive z components.
+     */
+    constexpr void store(T* x, T* y, T* z) const {
+        e[0].store(x);
+        e[1].store(y);
+        e[2].store(z);
+    }
+
+    /**
+     * @brief Stores the lanes as W consecutive vectors (array of structures).
+     * @param v Pointer to the first vector.
+     */
+    constexpr void store(vec<T, 3>* v) const {
+        for (int i = 0; i < W; i++)
+            v[i] = get(i);
+    }
+
+    /**
+     * @brief Extracts the vector of one lane.
+     * @param i The lane.
+     * @return The vector.
+     */
+    constexpr vec<T, 3> get(int i) const { return vec<T, 3>(e[0].v[i], e[1].v[i], e[2].v[i]); }
+
+    /**
+     * @brief Replaces the vector of one lane.
+     * @param i The lane.
+     * @param v The new vector.
+     */
+    constexpr void set(int i, const vec<T, 3> &v) {
+        e[0].v[i] = v.e[0];
+        e[1].v[i] = v.e[1];
+        e[2].v[i] = v.e[2];
+    }
+
+    /**
+     * @brief Getter for the x components.
+     */
+    constexpr const scalar& x() const { return e[0]; }
+
+    /**
+     * @brief Getter for the y components.
+     */
+    constexpr const scalar& y() const { return e[1]; }
+
+    /**
+     * @brief Getter for the z components.
+     */
+    constexpr const scalar& z() const { return e[2]; }
+
+    /**
+     * @brief Overloads the unary minus operator to negate every lane.
+     */
+    constexpr vec3xN operator-() const { return vec3xN(-e[0], -e[1], -e[2]); }
+
+    /**
+     * @brief Overloads the += operator to add another packet to this packet.
+     */
+    constexpr vec3xN& operator+=(const vec3xN &v) {
+        for (int k = 0; k < 3; k++)
+            e[k] = e[k] + v.e[k];
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the -= operator to subtract another packet from this packet.
+     */
+    constexpr vec3xN& operator-=(const vec3xN &v) {
+        for (int k = 0; k < 3; k++)
+            e[k] = e[k] - v.e[k];
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the *= operator to multiply every lane by its own scalar.
+     */
+    constexpr vec3xN& operator*=(const scalar &t) {
+        for (int k = 0; k < 3; k++)
+            e[k] = e[k] * t;
+        return *this;
+    }
+
+    /**
+     * @brief Overloads the /= operator to divide every lane by its own scalar.
+     */
+    constexpr vec3xN& operator/=(const scalar &t) {
+        return *this *= scalar(T(1)) / t;
+    }
+
+    /**
+     * @brief Calculates the squared length of every lane.
+     */
+    constexpr scalar length_squared() const { return e[0]*e[0] + e[1]*e[1] + e[2]*e[2]; }
+
+    /**
+     * @brief Calculates the length of every lane.
+     */
+    scalar length() const { return sqrt(length_squared()); }
+
+    /**
+     * @brief Checks which lanes are near zero in every component.
+     */
+    constexpr mask near_zero() const {
+        const scalar s(static_cast<T>(1e-8));
+        mask r(true);
+        for (int k = 0; k < 3; k++)
+            r = r & (e[k] < s) & (-s < e[k]);
+        return r;
+    }
+};
+
+// Packet Utility Functions
+
+/**
+ * @brief Overloads the + operator to add two packets lane by lane.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator+(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(u.e[0] + v.e[0], u.e[1] + v.e[1], u.e[2] + v.e[2]);
+}
+
+/**
+ * @brief Overloads the - operator to subtract two packets lane by lane.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator-(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(u.e[0] - v.e[0], u.e[1] - v.e[1], u.e[2] - v.e[2]);
+}
+
+/**
+ * @brief Overloads the * operator to multiply two packets component-wise.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator*(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(u.e[0] * v.e[0], u.e[1] * v.e[1], u.e[2] * v.e[2]);
+}
+
+/**
+ * @brief Overloads the * operator to multiply every lane by its own scalar.
+ * @param t The scalars.
+ * @param v The packet.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator*(const packet<T, W> &t, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(t * v.e[0], t * v.e[1], t * v.e[2]);
+}
+
+/**
+ * @brief Overloads the * operator to multiply every lane by its own scalar.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator*(const vec3xN<T, W> &v, const packet<T, W> &t) {
+    return t * v;
+}
+
+/**
+ * @brief Overloads the * operator to multiply every lane by the same scalar.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator*(typename vec3xN<T, W>::value_type t, const vec3xN<T, W> &v) {
+    return packet<T, W>(t) * v;
+}
+
+/**
+ * @brief Overloads the * operator to multiply every lane by the same scalar.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator*(const vec3xN<T, W> &v, typename vec3xN<T, W>::value_type t) {
+    return packet<T, W>(t) * v;
+}
+
+/**
+ * @brief Overloads the / operator to divide every lane by its own scalar.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator/(const vec3xN<T, W> &v, const packet<T, W> &t) {
+    return (packet<T, W>(T(1)) / t) * v;
+}
+
+/**
+ * @brief Overloads the / operator to divide every lane by the same scalar.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> operator/(const vec3xN<T, W> &v, typename vec3xN<T, W>::value_type t) {
+    return (1/t) * v;
+}
+
+/**
+ * @brief Calculates the dot product of every lane.
+ */
+template <typename T, int W>
+constexpr packet<T, W> dot(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return u.e[0] * v.e[0] + u.e[1] * v.e[1] + u.e[2] * v.e[2];
+}
+
+/**
+ * @brief Calculates the cross product of every lane.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> cross(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(u.e[1] * v.e[2] - u.e[2] * v.e[1],
+                        u.e[2] * v.e[0] - u.e[0] * v.e[2],
+                        u.e[0] * v.e[1] - u.e[1] * v.e[0]);
+}
+
+/**
+ * @brief Calculates the unit vector of every lane.
+ */
+template <typename T, int W>
+vec3xN<T, W> unit_vector(const vec3xN<T, W> &v) {
+    return v / v.length();
+}
+
+/**
+ * @brief Calculates the component-wise minimum of every lane.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> min(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(min(u.e[0], v.e[0]), min(u.e[1], v.e[1]), min(u.e[2], v.e[2]));
+}
+
+/**
+ * @brief Calculates the component-wise maximum of every lane.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> max(const vec3xN<T, W> &u, const vec3xN<T, W> &v) {
+    return vec3xN<T, W>(max(u.e[0], v.e[0]), max(u.e[1], v.e[1]), max(u.e[2], v.e[2]));
+}
+
+/**
+ * @brief Picks each lane from `a` where the mask is set and from `b` elsewhere.
+ */
+template <typename T, int W>
+constexpr vec3xN<T, W> select(const packet_mask<T, W> &m, const vec3xN<T, W> &a, const vec3xN<T, W> &b) {
+    return vec3xN<T, W>(select(m, a.e[0], b.e[0]), select(m, a.e[1], b.e[1]), select(m, a.e[2], b.e[2]));
+}
+
+/// 4 float vectors, one SSE register per component.
+using vec3x4 = vec3xN<float, 4>;
+
+/// 8 float vectors, one AVX register per component.
+using vec3x8 = vec3xN<float, 8>;
+
+/// 4 float scalars.
+using floatx4 = packet<float, 4>;
+
+/// 8 float scalars.
+using floatx8 = packet<float, 8>;
+
+#endif
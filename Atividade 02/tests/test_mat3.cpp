@@ -56,4 +56,34 @@ TEST(Mat3Test, OperatorOutput) {
     out << m;
     std::string expected_output = "1 2 3\n4 5 6\n7 8 9\n";
     EXPECT_EQ(out.str(), expected_output);
-}
\ No newline at end of file
+}
+
+TEST(Mat3Test, MultiplyByIdentity) {
+    mat3 m(vec3(1, 2, 3), vec3(4, 5, 6), vec3(7, 8, 10));
+    mat3 p = m * mat3::identity();
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(p[i].x(), m[i].x());
+        EXPECT_EQ(p[i].y(), m[i].y());
+        EXPECT_EQ(p[i].z(), m[i].z());
+    }
+}
+
+TEST(Mat3Test, MultiplyVector) {
+    mat3 m(vec3(1, 2, 3), vec3(4, 5, 6), vec3(7, 8, 9));
+    vec3 v = m * vec3(1, 0, -1);
+    EXPECT_EQ(v.x(), -2.0);
+    EXPECT_EQ(v.y(), -2.0);
+    EXPECT_EQ(v.z(), -2.0);
+}
+
+TEST(Mat3Test, TransposeDeterminantAndInverse) {
+    mat3 m(vec3(2, 0, 1), vec3(1, 3, 0), vec3(0, 1, 4));
+    EXPECT_EQ(m.transpose()[0].y(), 1.0);
+    EXPECT_EQ(m.transpose()[2].x(), 1.0);
+    EXPECT_NEAR(m.determinant(), 25.0, 1e-5);
+
+    mat3 p = m * m.inverse();
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            EXPECT_NEAR(p[i][j], i == j ? 1.0 : 0.0, 1e-5);
+}
@@ -46,4 +46,53 @@ TEST(Mat4Test, ElementAccess) {
     EXPECT_EQ(m[1], row1);
     EXPECT_EQ(m[2], row2);
     EXPECT_EQ(m[3], row3);
-}
\ No newline at end of file
+}
+
+TEST(Mat4Test, Multiply) {
+    mat4 a(vec4(1, 2, 3, 4), vec4(5, 6, 7, 8), vec4(9, 10, 11, 12), vec4(13, 14, 15, 16));
+    mat4 b = mat4::identity();
+    b[0].w = 1.0;
+    mat4 p = a * b;
+    EXPECT_EQ(p[0], vec4(1, 2, 3, 5));
+    EXPECT_EQ(p[3], vec4(13, 14, 15, 29));
+    mat4 l = mat4::identity() * a, r = a * mat4::identity();
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(l[i], r[i]);
+}
+
+TEST(Mat4Test, TransposeAndDeterminant) {
+    mat4 a(vec4(1, 2, 3, 4), vec4(5, 6, 7, 8), vec4(9, 10, 11, 12), vec4(13, 14, 15, 16));
+    mat4 t = a.transpose();
+    EXPECT_EQ(t[0], vec4(1, 5, 9, 13));
+    EXPECT_EQ(t[3], vec4(4, 8, 12, 16));
+    EXPECT_DOUBLE_EQ(a.determinant(), 0.0);
+    EXPECT_DOUBLE_EQ(mat4::scaling(vec3(2, 3, 4)).determinant(), 24.0);
+}
+
+TEST(Mat4Test, Inverse) {
+    mat4 m = mat4::translation(vec3(1, -2, 3)) * mat4::rotation(vec3(1, 1, 0), 0.7) * mat4::scaling(vec3(2, 0.5, 3));
+    mat4 p = m * m.inverse();
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            EXPECT_NEAR(p.at(i, j), i == j ? 1.0 : 0.0, 1e-5);
+}
+
+TEST(Mat4Test, TransformPointAndVector) {
+    mat4 m = mat4::translation(vec3(1, 2, 3)) * mat4::scaling(vec3(2, 2, 2));
+    point3 p = transform_point(m, point3(1, 1, 1));
+    EXPECT_EQ(p.x(), 3.0);
+    EXPECT_EQ(p.y(), 4.0);
+    EXPECT_EQ(p.z(), 5.0);
+    vec3 v = transform_vector(m, vec3(1, 0, 0));
+    EXPECT_EQ(v.x(), 2.0);
+    EXPECT_EQ(v.y(), 0.0);
+    EXPECT_EQ(v.z(), 0.0);
+}
+
+TEST(Mat4Test, NormalMatrixKeepsNormalsPerpendicular) {
+    mat4 m = mat4::rotation(vec3(0, 0, 1), 0.3) * mat4::scaling(vec3(4, 1, 1));
+    vec3 tangent(1, 1, 0), normal(1, -1, 0);
+    vec3 t = transform_vector(m, tangent);
+    vec3 n = normal_matrix(m) * normal;
+    EXPECT_NEAR(dot(t, n), 0.0, 1e-5);
+}
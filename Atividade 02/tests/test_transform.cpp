@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "../includes/transform.h"
+
+#include <vector>
+
+// 37 pontos: exercita os laços de 8 (AVX), de 4 (SSE) e o final escalar.
+static std::vector<float> sample_points(size_t count) {
+    std::vector<float> points;
+    for (size_t i = 0; i < count; i++) {
+        points.push_back(0.5f * i - 3.0f);
+        points.push_back(1.0f - 0.25f * i);
+        points.push_back(0.125f * i * i);
+    }
+    return points;
+}
+
+TEST(TransformTest, PointsMatchTransformPoint) {
+    mat4 m = mat4::translation(vec3(1, -2, 3)) * mat4::rotation(vec3(0, 1, 1), 0.4) * mat4::scaling(vec3(2, 1, 0.5));
+    std::vector<float> in = sample_points(37), out(in.size());
+    transform_points(m, in.data(), out.data(), 37);
+    for (size_t i = 0; i < 37; i++) {
+        point3 expected = transform_point(m, point3(in[3*i], in[3*i + 1], in[3*i + 2]));
+        EXPECT_NEAR(out[3*i], expected.x(), 1e-4);
+        EXPECT_NEAR(out[3*i + 1], expected.y(), 1e-4);
+        EXPECT_NEAR(out[3*i + 2], expected.z(), 1e-4);
+    }
+}
+
+TEST(TransformTest, InPlaceTranslationIsExact) {
+    std::vector<float> points = sample_points(37), expected = points;
+    transform_points(mat4::translation(vec3(0, 1, 0)), points.data(), points.data(), 37);
+    for (size_t i = 0; i < 37; i++) {
+        EXPECT_EQ(points[3*i], expected[3*i]);
+        EXPECT_EQ(points[3*i + 1], expected[3*i + 1] + 1.0f);
+        EXPECT_EQ(points[3*i + 2], expected[3*i + 2]);
+    }
+}
+
+TEST(TransformTest, VectorsIgnoreTranslation) {
+    std::vector<float> v = {1, 0, 0, 0, 1, 0, 0, 0, 1}, out(9);
+    transform_vectors(mat4::translation(vec3(5, 5, 5)), v.data(), out.data(), 3);
+    EXPECT_EQ(out, v);
+}
+
+TEST(TransformTest, NormalsAreUnitAndPerpendicular) {
+    mat4 m = mat4::rotation(vec3(1, 0, 0), 0.9) * mat4::scaling(vec3(3, 1, 0.2));
+    // Normais de planos que contêm o eixo z: a tangente (0, 0, 1) continua perpendicular.
+    std::vector<float> normals;
+    for (int i = 0; i < 37; i++) {
+        normals.push_back(std::cos(0.1f * i));
+        normals.push_back(std::sin(0.1f * i));
+        normals.push_back(0.0f);
+    }
+    std::vector<float> out(normals.size());
+    transform_normals(normal_matrix(m), normals.data(), out.data(), 37);
+    vec3 tangent = transform_vector(m, vec3(0, 0, 1));
+    for (size_t i = 0; i < 37; i++) {
+        vec3 n(out[3*i], out[3*i + 1], out[3*i + 2]);
+        EXPECT_NEAR(n.length(), 1.0, 1e-5);
+        EXPECT_NEAR(dot(n, tangent), 0.0, 1e-5);
+    }
+}
@@ -65,5 +65,46 @@ TEST(Vec3Test, LengthSquared) {
     EXPECT_EQ(v.length_squared(), 9.0);
 }
 
+TEST(Vec3Test, DotAndCross) {
+    vec3 u(1.0, 2.0, 3.0);
+    vec3 v(4.0, 5.0, 6.0);
+    EXPECT_EQ(dot(u, v), 32.0);
+    vec3 c = cross(u, v);
+    EXPECT_EQ(c.x(), -3.0);
+    EXPECT_EQ(c.y(), 6.0);
+    EXPECT_EQ(c.z(), -3.0);
+}
+
+TEST(Vec3Test, ScalarOperators) {
+    vec3 v = 2 * vec3(1.0, 2.0, 3.0) / 4;
+    EXPECT_EQ(v.x(), 0.5);
+    EXPECT_EQ(v.y(), 1.0);
+    EXPECT_EQ(v.z(), 1.5);
+}
 
+TEST(Vec3Test, ConstexprOperations) {
+    constexpr vec3 u(1.0, 0.0, 0.0);
+    constexpr vec3 v(0.0, 1.0, 0.0);
+    static_assert(dot(u, v) == 0.0, "dot must be usable in constant expressions");
+    static_assert(cross(u, v).z() == 1.0, "cross must be usable in constant expressions");
+    static_assert((u + v - u).y() == 1.0, "operators must be usable in constant expressions");
+    static_assert((2.0 * u).length_squared() == 4.0, "length_squared must be usable in constant expressions");
+    SUCCEED();
+}
 
+TEST(Vec3fTest, FloatInstantiation) {
+    vec3f v(1.0f, 2.0f, 2.0f);
+    static_assert(std::is_same<decltype(v.length()), float>::value, "vec3f components must be float");
+    EXPECT_EQ(sizeof(vec3f), 3 * sizeof(float));
+    EXPECT_FLOAT_EQ(v.length(), 3.0f);
+    EXPECT_FLOAT_EQ(unit_vector(v).x(), 1.0f / 3.0f);
+}
+
+TEST(Vec3fTest, ConvertsBetweenPrecisions) {
+    vec3 d(0.5, -1.25, 2.0);
+    vec3f f(d);
+    EXPECT_EQ(f.x(), 0.5f);
+    EXPECT_EQ(f.y(), -1.25f);
+    EXPECT_EQ(f.z(), 2.0f);
+    EXPECT_EQ(vec3(f).y(), -1.25);
+}
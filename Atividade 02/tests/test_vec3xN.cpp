@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include "../includes/vec3xN.h"
+
+static void expect_vec3_eq(const vec3f& a, const vec3f& b) {
+    EXPECT_EQ(a.x(), b.x());
+    EXPECT_EQ(a.y(), b.y());
+    EXPECT_EQ(a.z(), b.z());
+}
+
+static vec3f sample(int i) {
+    return vec3f(1.5f * i - 4.0f, 2.0f - 0.5f * i, 0.25f * i * i + 1.0f);
+}
+
+static vec3x8 sample_packet(int offset) {
+    vec3f v[8];
+    for (int i = 0; i < 8; i++)
+        v[i] = sample(i + offset);
+    return vec3x8::load(v);
+}
+
+TEST(Vec3xNTest, DefaultConstructor) {
+    vec3x4 v;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(v.x()[i], 0.0f);
+        EXPECT_EQ(v.y()[i], 0.0f);
+        EXPECT_EQ(v.z()[i], 0.0f);
+    }
+}
+
+TEST(Vec3xNTest, Broadcast) {
+    vec3x4 v(vec3f(1, 2, 3));
+    for (int i = 0; i < 4; i++)
+        expect_vec3_eq(v.get(i), vec3f(1, 2, 3));
+}
+
+TEST(Vec3xNTest, LoadStoreArrayOfStructures) {
+    vec3f in[8], out[8];
+    for (int i = 0; i < 8; i++)
+        in[i] = sample(i);
+    vec3x8::load(in).store(out);
+    for (int i = 0; i < 8; i++)
+        expect_vec3_eq(out[i], in[i]);
+}
+
+TEST(Vec3xNTest, LoadStoreStructureOfArrays) {
+    float x[4] = {1, 2, 3, 4}, y[4] = {5, 6, 7, 8}, z[4] = {9, 10, 11, 12};
+    vec3x4 v = vec3x4::load(x, y, z);
+    expect_vec3_eq(v.get(2), vec3f(3, 7, 11));
+
+    float ox[4], oy[4], oz[4];
+    (v + v).store(ox, oy, oz);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(ox[i], 2 * x[i]);
+        EXPECT_EQ(oy[i], 2 * y[i]);
+        EXPECT_EQ(oz[i], 2 * z[i]);
+    }
+}
+
+TEST(Vec3xNTest, ArithmeticMatchesVec3) {
+    vec3x8 a = sample_packet(0), b = sample_packet(3);
+    floatx8 t;
+    for (int i = 0; i < 8; i++)
+        t[i] = 0.5f + i;
+    vec3x8 sum = a + b, diff = a - b, prod = a * b, scaled = t * a, quot = a / t, neg = -a, half = a / 2.0f;
+    for (int i = 0; i < 8; i++) {
+        vec3f u = sample(i), v = sample(i + 3);
+        expect_vec3_eq(sum.get(i), u + v);
+        expect_vec3_eq(diff.get(i), u - v);
+        expect_vec3_eq(prod.get(i), u * v);
+        expect_vec3_eq(scaled.get(i), t[i] * u);
+        expect_vec3_eq(neg.get(i), -u);
+        expect_vec3_eq(half.get(i), u / 2.0f);
+        for (int k = 0; k < 3; k++)
+            EXPECT_FLOAT_EQ(quot.get(i)[k], (u / t[i])[k]);
+    }
+}
+
+TEST(Vec3xNTest, DotCrossAndLengthMatchVec3) {
+    vec3x8 a = sample_packet(0), b = sample_packet(5);
+    floatx8 d = dot(a, b), len = a.length();
+    vec3x8 c = cross(a, b), unit = unit_vector(a);
+    for (int i = 0; i < 8; i++) {
+        vec3f u = sample(i), v = sample(i + 5);
+        EXPECT_EQ(d[i], dot(u, v));
+        expect_vec3_eq(c.get(i), cross(u, v));
+        EXPECT_FLOAT_EQ(len[i], u.length());
+        for (int k = 0; k < 3; k++)
+            EXPECT_FLOAT_EQ(unit.get(i)[k], unit_vector(u)[k]);
+    }
+}
+
+TEST(Vec3xNTest, MinAndMax) {
+    vec3x4 a(floatx4(1), floatx4(5), floatx4(-2));
+    vec3x4 b(floatx4(3), floatx4(4), floatx4(-1));
+    expect_vec3_eq(min(a, b).get(0), vec3f(1, 4, -2));
+    expect_vec3_eq(max(a, b).get(3), vec3f(3, 5, -1));
+}
+
+TEST(Vec3xNTest, SelectWithMask) {
+    vec3x8 a = sample_packet(0), b = sample_packet(10);
+    floatx8 lane;
+    for (int i = 0; i < 8; i++)
+        lane[i] = static_cast<float>(i);
+    vec3x8::mask m = (lane < floatx8(3.0f)) | (lane >= floatx8(6.0f));
+    EXPECT_EQ(m.to_bits(), 0xC7u);
+    EXPECT_TRUE(any(m));
+    EXPECT_FALSE(all(m));
+    EXPECT_TRUE(all(m | !m));
+    EXPECT_TRUE(none(m & !m));
+
+    vec3x8 s = select(m, a, b);
+    for (int i = 0; i < 8; i++)
+        expect_vec3_eq(s.get(i), m[i] ? sample(i) : sample(i + 10));
+}
+
+TEST(Vec3xNTest, NearZero) {
+    vec3x4 v(vec3f(1e-9f, -1e-9f, 0));
+    v.set(2, vec3f(1e-9f, 1, 0));
+    EXPECT_EQ(v.near_zero().to_bits(), 0xBu);
+}
+
+TEST(Vec3xNTest, DoubleLanes) {
+    using vec3dx4 = vec3xN<double, 4>;
+    vec3dx4 v(vec<double, 3>(3, 4, 12));
+    packet<double, 4> len = v.length();
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(len[i], 13.0);
+}
+
+// Compara a raiz de cada posição com std::sqrt, inclusive nas larguras que não ocupam um registrador inteiro.
+template <typename T, int W>
+static void expect_sqrt_matches_scalar() {
+    packet<T, W> p;
+    for (int i = 0; i < W; i++)
+        p.v[i] = T(0.75) * i * i + T(2);
+    packet<T, W> r = sqrt(p);
+    for (int i = 0; i < W; i++)
+        EXPECT_EQ(r[i], std::sqrt(p[i]));
+}
+
+TEST(Vec3xNTest, SqrtMatchesScalar) {
+    expect_sqrt_matches_scalar<float, 3>();
+    expect_sqrt_matches_scalar<float, 4>();
+    expect_sqrt_matches_scalar<float, 8>();
+    expect_sqrt_matches_scalar<float, 13>();
+    expect_sqrt_matches_scalar<float, 16>();
+    expect_sqrt_matches_scalar<double, 2>();
+    expect_sqrt_matches_scalar<double, 3>();
+    expect_sqrt_matches_scalar<double, 8>();
+    EXPECT_TRUE(std::isnan(sqrt(floatx4(-1.0f))[2]));
+}
+
+TEST(Vec3xNTest, NonPowerOfTwoWidth) {
+    using vec3fx3 = vec3xN<float, 3>;
+    static_assert(alignof(packet<float, 3>) == 16, "3 floats are aligned like 4");
+    static_assert(alignof(packet_mask<float, 3>) == 16, "3 lanes are aligned like 4");
+    vec3fx3 v(vec3f(3, 4, 12));
+    packet<float, 3> len = v.length();
+    for (int i = 0; i < 3; i++)
+        EXPECT_EQ(len[i], 13.0f);
+}
+
+// Um teste raio-esfera escrito uma vez para 8 raios.
+TEST(Vec3xNTest, RaySphereKernel) {
+    vec3x8 origin(vec3f(0, 0, 0));
+    vec3x8 direction;
+    for (int i = 0; i < 8; i++)
+        direction.set(i, vec3f(0.2f * (i - 4), 0, -1));
+    vec3x8 center(vec3f(0, 0, -5));
+    floatx8 radius(1.0f);
+
+    vec3x8 oc = center - origin;
+    floatx8 a = direction.length_squared(), h = dot(direction, oc);
+    floatx8 c = oc.length_squared() - radius * radius;
+    floatx8 discriminant = h * h - a * c;
+    vec3x8::mask hit = discriminant >= floatx8(0.0f);
+    floatx8 t = select(hit, (h - sqrt(max(discriminant, floatx8(0.0f)))) / a, floatx8(-1.0f));
+
+    for (int i = 0; i < 8; i++) {
+        vec3f d = direction.get(i), o = vec3f(0, 0, -5);
+        float ha = dot(d, o), disc = ha * ha - d.length_squared() * (o.length_squared() - 1);
+        EXPECT_EQ(hit[i], disc >= 0);
+        if (disc >= 0) {
+            EXPECT_FLOAT_EQ(t[i], (ha - std::sqrt(disc)) / d.length_squared());
+        }
+    }
+    EXPECT_EQ(hit.to_bits(), 0x38u);
+}
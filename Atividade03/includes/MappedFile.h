@@ -0,0 +1,106 @@
+/**
+ * @file MappedFile.h
+ * @brief Classe para acesso somente leitura ao conteúdo de um arquivo mapeado em memória.
+ * @author Martin Henrique Viana Adam
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Arquivo inteiro visível como um único bloco de bytes, sem cópia para a memória do processo.
+ *
+ * Em sistemas POSIX o arquivo é mapeado com `mmap` e as páginas são lidas sob demanda pelo
+ * sistema operacional; em outros sistemas o conteúdo é lido de uma vez para um buffer. O bloco não
+ * termina com '\0': use sempre `data()` junto de `size()`.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Abre e mapeia um arquivo.
+     * @param filename Nome do arquivo.
+     */
+    explicit MappedFile(const std::string& filename) {
+#if defined(_WIN32)
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return;
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        bytes = buffer.data();
+        length = buffer.size();
+        opened = true;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat info;
+        if (::fstat(fd, &info) == 0) {
+            length = static_cast<size_t>(info.st_size);
+            opened = true;
+            if (length > 0) {
+                void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    length = 0;
+                    opened = false;
+                } else {
+                    ::madvise(address, length, MADV_SEQUENTIAL);
+                    bytes = static_cast<const char*>(address);
+                }
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (bytes != nullptr)
+            ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Indica se o arquivo foi aberto.
+     * @return true se o arquivo existe e pôde ser lido.
+     */
+    bool is_open() const { return opened; }
+
+    /**
+     * @brief Obtém o início do conteúdo do arquivo.
+     * @return Ponteiro para o primeiro byte (nulo se o arquivo estiver vazio).
+     */
+    const char* data() const { return bytes; }
+
+    /**
+     * @brief Obtém o tamanho do arquivo.
+     * @return Quantidade de bytes.
+     */
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr; ///< Início do conteúdo.
+    size_t length = 0; ///< Tamanho do conteúdo em bytes.
+    bool opened = false; ///< Se o arquivo foi aberto.
+#if defined(_WIN32)
+    std::vector<char> buffer; ///< Conteúdo lido, quando não há `mmap`.
+#endif
+};
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file MeshCache.h
+ * @brief Formato binário de cache das malhas lidas de arquivos OBJ.
+ * @author Martin Henrique Viana Adam
+ */
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief Versão do formato. Deve ser incrementada sempre que o cabeçalho ou o conteúdo mudar,
+ * para que caches antigos sejam descartados.
+ */
+constexpr uint32_t MESH_CACHE_VERSION = 2;
+
+/// Quantidade de vetores guardados no cache: vértices, coordenadas de textura, normais e os
+/// índices de posição, de coordenada de textura e de normal das faces.
+constexpr int MESH_CACHE_ARRAYS = 6;
+
+/// Posição, entre os vetores do cache, dos índices de posição; os índices de coordenada de textura
+/// e de normal vêm logo depois.
+constexpr int MESH_CACHE_POSITION_INDICES = 3;
+
+/// Alinhamento, em bytes, do início de cada vetor dentro do arquivo.
+constexpr uint64_t MESH_CACHE_ALIGNMENT = 64;
+
+/**
+ * @brief Cabeçalho do arquivo de cache, seguido pelos vetores, cada um alinhado a 64 bytes.
+ *
+ * O cache é válido para um arquivo OBJ com o mesmo tamanho e a mesma data de modificação. Se apenas
+ * a data mudou (o arquivo foi copiado ou salvo sem alterações), o hash do conteúdo é comparado com
+ * `source_hash`. Os números são gravados na ordem de bytes da máquina que criou o cache.
+ */
+struct MeshCacheHeader {
+    char magic[8];                       ///< "OBJMESH" seguido de '\0'.
+    uint32_t version;                    ///< MESH_CACHE_VERSION.
+    uint32_t header_size;                ///< sizeof(MeshCacheHeader).
+    uint64_t source_size;                ///< Tamanho do arquivo OBJ em bytes.
+    int64_t source_mtime;                ///< Data de modificação do arquivo OBJ.
+    uint64_t source_hash;                ///< Hash do conteúdo do arquivo OBJ (`content_hash`).
+    uint64_t element_size[MESH_CACHE_ARRAYS]; ///< Tamanho de um elemento de cada vetor.
+    uint64_t count[MESH_CACHE_ARRAYS];   ///< Quantidade de elementos de cada vetor.
+    uint64_t offset[MESH_CACHE_ARRAYS];  ///< Posição de cada vetor, em bytes, a partir do início do arquivo.
+};
+
+/**
+ * @brief Um vetor a ser gravado no cache.
+ */
+struct MeshCacheArray {
+    const void* data;    ///< Primeiro elemento.
+    uint64_t count;      ///< Quantidade de elementos.
+    uint64_t element_size; ///< Tamanho de um elemento em bytes.
+};
+
+/**
+ * @brief Nome do arquivo de cache de um arquivo OBJ.
+ * @param obj_path Caminho do arquivo OBJ.
+ * @return O mesmo caminho com a extensão `.meshcache` acrescentada.
+ */
+inline std::string mesh_cache_path(const std::string& obj_path) {
+    return obj_path + ".meshcache";
+}
+
+/**
+ * @brief Hash FNV-1a de 64 bits do conteúdo, processado de 8 em 8 bytes.
+ * @param data Início do conteúdo.
+ * @param size Tamanho do conteúdo em bytes.
+ * @return O hash.
+ */
+inline uint64_t content_hash(const char* data, size_t size) {
+    const uint64_t prime = 1099511628211ull;
+    uint64_t hash = 14695981039346656037ull ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; i++)
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    return hash;
+}
+
+/**
+ * @brief Obtém o tamanho e a data de modificação de um arquivo.
+ * @return false se o arquivo não existir.
+ */
+inline bool mesh_source_key(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error)
+        return false;
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief Mapeia o cache de um arquivo OBJ, se ele existir e corresponder ao arquivo atual.
+ *
+ * @param obj_path Caminho do arquivo OBJ.
+ * @param element_size Tamanho esperado de um elemento de cada vetor.
+ * @return O cache mapeado, ou nulo se ele não existir, for de outra versão ou estiver desatualizado.
+ */
+inline std::shared_ptr<const MappedFile> open_mesh_cache(const std::string& obj_path,
+                                                         const uint64_t (&element_size)[MESH_CACHE_ARRAYS]) {
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!mesh_source_key(obj_path, source_size, source_mtime))
+        return nullptr;
+
+    auto file = std::make_shared<const MappedFile>(mesh_cache_path(obj_path));
+    if (!file->is_open() || file->size() < sizeof(MeshCacheHeader))
+        return nullptr;
+
+    MeshCacheHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, "OBJMESH", 8) != 0 || header.version != MESH_CACHE_VERSION ||
+        header.header_size != sizeof(MeshCacheHeader))
+        return nullptr;
+    for (int k = 0; k < MESH_CACHE_ARRAYS; k++) {
+        if (header.element_size[k] != element_size[k] || header.offset[k] % MESH_CACHE_ALIGNMENT != 0 ||
+            header.offset[k] > file->size() || header.count[k] > (file->size() - header.offset[k]) / element_size[k])
+            return nullptr;
+    }
+    // Os índices de coordenada de textura e de normal são lidos na mesma posição dos índices de
+    // posição, então cada um deve estar vazio ou ter a mesma quantidade, múltipla de 3.
+    if (header.count[MESH_CACHE_POSITION_INDICES] % 3 != 0)
+        return nullptr;
+    for (int k = MESH_CACHE_POSITION_INDICES + 1; k < MESH_CACHE_ARRAYS; k++) {
+        if (header.count[k] != 0 && header.count[k] != header.count[MESH_CACHE_POSITION_INDICES])
+            return nullptr;
+    }
+
+    if (header.source_size != source_size)
+        return nullptr;
+    if (header.source_mtime != source_mtime) {
+        MappedFile source(obj_path);
+        if (!source.is_open() || content_hash(source.data(), source.size()) != header.source_hash)
+            return nullptr;
+    }
+    return file;
+}
+
+/**
+ * @brief Obtém a posição e a quantidade de elementos de um vetor de um cache já validado.
+ * @param file Cache devolvido por `open_mesh_cache`.
+ * @param k Índice do vetor.
+ * @param count Quantidade de elementos.
+ * @return Ponteiro para o primeiro elemento.
+ */
+inline const void* mesh_cache_array(const MappedFile& file, int k, size_t& count) {
+    MeshCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    count = static_cast<size_t>(header.count[k]);
+    return file.data() + header.offset[k];
+}
+
+/**
+ * @brief Grava o cache de um arquivo OBJ.
+ *
+ * O arquivo é escrito com outro nome e renomeado no final, então uma leitura simultânea nunca vê
+ * um cache incompleto. Falhas (por exemplo, uma pasta sem permissão de escrita) são ignoradas.
+ *
+ * @param obj_path Caminho do arquivo OBJ.
+ * @param source Conteúdo do arquivo OBJ, usado para calcular o hash.
+ * @param arrays Vetores a gravar.
+ * @return true se o cache foi gravado.
+ */
+inline bool write_mesh_cache(const std::string& obj_path, const MappedFile& source,
+                             const MeshCacheArray (&arrays)[MESH_CACHE_ARRAYS]) {
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, "OBJMESH", 8);
+    header.version = MESH_CACHE_VERSION;
+    header.header_size = sizeof(MeshCacheHeader);
+    if (!mesh_source_key(obj_path, header.source_size, header.source_mtime) || header.source_size != source.size())
+        return false;
+    header.source_hash = content_hash(source.data(), source.size());
+
+    uint64_t position = (sizeof(MeshCacheHeader) + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+    for (int k = 0; k < MESH_CACHE_ARRAYS; k++) {
+        header.element_size[k] = arrays[k].element_size;
+        header.count[k] = arrays[k].count;
+        header.offset[k] = position;
+        position += arrays[k].count * arrays[k].element_size;
+        position = (position + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+    }
+
+    const std::string path = mesh_cache_path(obj_path);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        const char padding[MESH_CACHE_ALIGNMENT] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t written = sizeof(header);
+        for (int k = 0; k < MESH_CACHE_ARRAYS; k++) {
+            out.write(padding, static_cast<std::streamsize>(header.offset[k] - written));
+            out.write(static_cast<const char*>(arrays[k].data), static_cast<std::streamsize>(arrays[k].count * arrays[k].element_size));
+            written = header.offset[k] + arrays[k].count * arrays[k].element_size;
+        }
+        if (!out.good()) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif
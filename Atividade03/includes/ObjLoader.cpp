@@ -1,137 +1,671 @@
 #include "ObjLoader.h"
+#include "MeshCache.h"
+#include "../../Atividade05/includes/scheduler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <thread>
 
 Vertex ObjLoader::GetVertices(const int idx) const {
-    if (idx >= 0 && idx < vertices.size()) {
-        return vertices[idx];
+    Span<const Vertex> all = GetVertexSpan();
+    if (idx >= 0 && static_cast<size_t>(idx) < all.size()) {
+        return all[idx];
     }
 
     return Vertex();
 }
 
 std::vector<TextureCoord> ObjLoader::GetTextureCoords() const {
-    return textureCoords;
+    Span<const TextureCoord> all = GetTextureCoordSpan();
+    return std::vector<TextureCoord>(all.begin(), all.end());
 }
 
 Normal ObjLoader::GetNormals(const int idx) const {
-    if (idx >= 0 && idx < normals.size()) {
-        return normals[idx];
+    Span<const Normal> all = GetNormalSpan();
+    if (idx >= 0 && static_cast<size_t>(idx) < all.size()) {
+        return all[idx];
     }
 
     return Normal();
 }
 
 Face ObjLoader::GetFaces(const int i, const int j) const {
- if (i >= 0 && j >= 0 && i < faces.size()) {
-        return faces[i][j];
+    Span<const int> positions = GetPositionIndexSpan();
+    if (i >= 0 && j >= 0 && j < 3 && 3 * static_cast<size_t>(i) + j < positions.size()) {
+        const size_t k = 3 * static_cast<size_t>(i) + j;
+        Span<const int> texture_coords = GetTextureCoordIndexSpan();
+        Span<const int> normal_indices = GetNormalIndexSpan();
+        Face face;
+        face.v1 = positions[k] + 1;
+        face.v2 = texture_coords.empty() ? 0 : texture_coords[k] + 1;
+        face.v3 = normal_indices.empty() ? 0 : normal_indices[k] + 1;
+        return face;
     }
 
     return Face();
+}
+
+// Ordem dos vetores no cache e tamanho de cada elemento.
+enum CacheArray {
+    CACHE_VERTICES, CACHE_TEXTURE_COORDS, CACHE_NORMALS,
+    CACHE_POSITION_INDICES, CACHE_TEXTURE_COORD_INDICES, CACHE_NORMAL_INDICES
+};
+static_assert(CACHE_POSITION_INDICES == MESH_CACHE_POSITION_INDICES, "ordem dos vetores do cache");
+static const uint64_t cache_element_size[MESH_CACHE_ARRAYS] = {
+    sizeof(Vertex), sizeof(TextureCoord), sizeof(Normal), sizeof(int), sizeof(int), sizeof(int)
 };
 
-       
+/**
+ * @brief Visão de um vetor do cache mapeado.
+ */
+template <typename T>
+static Span<const T> cache_span(const MappedFile& file, CacheArray k) {
+    size_t count;
+    const void* data = mesh_cache_array(file, k, count);
+    return Span<const T>(static_cast<const T*>(data), count);
+}
 
-void ObjLoader::LoadObj(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Erro ao abrir o arquivo: " << filename << std::endl;
-        return;
+Span<const Vertex> ObjLoader::GetVertexSpan() const {
+    return cache ? cache_span<Vertex>(*cache, CACHE_VERTICES) : Span<const Vertex>(vertices);
+}
+
+Span<const TextureCoord> ObjLoader::GetTextureCoordSpan() const {
+    return cache ? cache_span<TextureCoord>(*cache, CACHE_TEXTURE_COORDS) : Span<const TextureCoord>(textureCoords);
+}
+
+Span<const Normal> ObjLoader::GetNormalSpan() const {
+    return cache ? cache_span<Normal>(*cache, CACHE_NORMALS) : Span<const Normal>(normals);
+}
+
+Span<const int> ObjLoader::GetPositionIndexSpan() const {
+    return cache ? cache_span<int>(*cache, CACHE_POSITION_INDICES) : Span<const int>(positionIndices);
+}
+
+Span<const int> ObjLoader::GetTextureCoordIndexSpan() const {
+    return cache ? cache_span<int>(*cache, CACHE_TEXTURE_COORD_INDICES) : Span<const int>(textureCoordIndices);
+}
+
+Span<const int> ObjLoader::GetNormalIndexSpan() const {
+    return cache ? cache_span<int>(*cache, CACHE_NORMAL_INDICES) : Span<const int>(normalIndices);
+}
+
+namespace {
+
+/**
+ * @brief Indica se um caractere separa campos de uma linha (espaço, tabulação ou '\r').
+ */
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Avança até o primeiro caractere que não separa campos.
+ */
+inline const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && is_blank(*p))
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Lê um número real no início do campo, sem alocar memória.
+ *
+ * Usa `std::from_chars`, que arredonda como o `operator>>` de `std::istream`. Um campo ausente ou
+ * inválido resulta em 0.
+ *
+ * @param p Posição atual na linha.
+ * @param end Fim da linha.
+ * @param value Valor lido.
+ * @return Posição logo após o número.
+ */
+inline const char* parse_float(const char* p, const char* end, float& value) {
+    p = skip_blanks(p, end);
+    if (p < end && *p == '+')
+        ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0.0f;
+        return p;
+    }
+    return result.ptr;
+}
+
+/**
+ * @brief Lê um índice de face no início do campo e o converte para começar em 0.
+ *
+ * No formato OBJ o índice -1 se refere ao último elemento lido até a linha atual. Um índice
+ * negativo é convertido usando a quantidade de elementos lidos até agora no bloco (`count`);
+ * como o bloco não sabe quantos elementos vêm dos blocos anteriores, `relative` indica que o
+ * resultado ainda precisa ser somado a essa quantidade. Um índice ausente resulta em -1.
+ *
+ * @param p Posição atual na linha.
+ * @param end Fim da linha.
+ * @param count Quantidade de elementos do tipo referenciado lidos até agora no bloco.
+ * @param value Índice lido.
+ * @param relative Se o índice era relativo.
+ * @return Posição logo após o índice.
+ */
+inline const char* parse_index(const char* p, const char* end, size_t count, int& value, bool& relative) {
+    relative = false;
+    if (p < end && *p == '+')
+        ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = -1;
+        return p;
     }
+    if (value < 0) {
+        value += static_cast<int>(count);
+        relative = true;
+    } else {
+        value -= 1;
+    }
+    return result.ptr;
+}
+
+/**
+ * @brief Lê um vértice de face (`p`, `p/t`, `p//n` ou `p/t/n`) no início do campo.
+ *
+ * @param q Posição atual na linha.
+ * @param line_end Fim da linha.
+ * @param count Quantidade de posições, coordenadas de textura e normais lidas até agora.
+ * @param index Índices lidos (começando em 0; -1 se ausente).
+ * @param relative Se cada índice era relativo (veja `parse_index`).
+ * @param present Se cada índice estava escrito no vértice. Um índice relativo ainda não corrigido
+ * pode valer -1, então o valor não basta para saber se o atributo é usado.
+ * @return Posição logo após o vértice.
+ */
+inline const char* parse_corner(const char* q, const char* line_end, const size_t (&count)[3],
+                                int (&index)[3], bool (&relative)[3], bool (&present)[3]) {
+    for (int k = 0; k < 3; k++) {
+        index[k] = -1;
+        relative[k] = false;
+        present[k] = false;
+    }
+    q = skip_blanks(q, line_end);
+    const char* field = q;
+    q = parse_index(q, line_end, count[0], index[0], relative[0]);
+    present[0] = q != field;
+    if (q < line_end && *q == '/') {
+        ++q;
+        if (q < line_end && *q != '/') {
+            field = q;
+            q = parse_index(q, line_end, count[1], index[1], relative[1]);
+            present[1] = q != field;
+        }
+        if (q < line_end && *q == '/') {
+            field = q + 1;
+            q = parse_index(field, line_end, count[2], index[2], relative[2]);
+            present[2] = q != field;
+        }
+    }
+    while (q < line_end && !is_blank(*q))
+        ++q;
+    return q;
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token;
+/**
+ * @brief Tipos de linha usados pelo leitor; as demais são ignoradas.
+ */
+enum LineType { LINE_OTHER, LINE_VERTEX, LINE_TEXTURE_COORD, LINE_NORMAL, LINE_FACE };
+
+/**
+ * @brief Identifica o tipo de uma linha pela primeira palavra.
+ * @param p Início da linha.
+ * @param line_end Fim da linha.
+ * @param rest Posição logo após a primeira palavra.
+ * @return Tipo da linha.
+ */
+inline LineType line_type(const char* p, const char* line_end, const char*& rest) {
+    const char* token = skip_blanks(p, line_end);
+    const char* q = token;
+    while (q < line_end && !is_blank(*q))
+        ++q;
+    rest = q;
+    const size_t token_size = q - token;
+
+    if (token_size == 1 && token[0] == 'v')
+        return LINE_VERTEX;
+    if (token_size == 2 && token[0] == 'v' && token[1] == 't')
+        return LINE_TEXTURE_COORD;
+    if (token_size == 2 && token[0] == 'v' && token[1] == 'n')
+        return LINE_NORMAL;
+    if (token_size == 1 && token[0] == 'f')
+        return LINE_FACE;
+    return LINE_OTHER;
+}
+
+/**
+ * @brief Elemento `index` de um vetor, ou zero se o índice não for válido.
+ */
+template <typename T>
+T element_or_zero(Span<const T> all, int index) {
+    return static_cast<size_t>(index) < all.size() ? all[index] : T();
+}
+
+/**
+ * @brief Elementos lidos de um bloco do arquivo, antes de serem juntados aos dos outros blocos.
+ */
+struct ObjChunk {
+    std::vector<Vertex> vertices;
+    std::vector<TextureCoord> textureCoords;
+    std::vector<Normal> normals;
+    /// Índices dos vértices das faces, por atributo: posição, textura e normal.
+    std::vector<int> indices[3];
+    /// Posições (em `indices`) de índices relativos, por atributo.
+    std::vector<uint32_t> relative[3];
+    /// Se alguma face do bloco usa cada atributo.
+    bool used[3] = {false, false, false};
+};
 
-        if (token == "v") {
+/**
+ * @brief Lê as linhas `v`, `vt`, `vn` e `f` de um trecho do arquivo que começa no início de uma linha.
+ *
+ * @param p Início do trecho.
+ * @param end Fim do trecho (fim de uma linha ou do arquivo).
+ * @param chunk Elementos lidos.
+ */
+void parse_chunk(const char* p, const char* const end, ObjChunk& chunk) {
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (line_end == nullptr)
+            line_end = end;
+
+        const char* q;
+        const LineType type = line_type(p, line_end, q);
+
+        if (type == LINE_VERTEX) {
             Vertex vertex;
-            iss >> vertex.x >> vertex.y >> vertex.z;
-            vertices.push_back(vertex);
-        } else if (token == "vt") {
+            q = parse_float(q, line_end, vertex.x);
+            q = parse_float(q, line_end, vertex.y);
+            parse_float(q, line_end, vertex.z);
+            chunk.vertices.push_back(vertex);
+        } else if (type == LINE_TEXTURE_COORD) {
             TextureCoord texCoord;
-            iss >> texCoord.u >> texCoord.v;
-            textureCoords.push_back(texCoord);
-        } else if (token == "vn") {
+            q = parse_float(q, line_end, texCoord.u);
+            parse_float(q, line_end, texCoord.v);
+            chunk.textureCoords.push_back(texCoord);
+        } else if (type == LINE_NORMAL) {
             Normal normal;
-            iss >> normal.nx >> normal.ny >> normal.nz;
-            normals.push_back(normal);
-        } else if (token == "f") {
-            std::vector<Face> faces_in_line;
-            for (int i = 0; i < 3; ++i) {
-                Face face;
-                if (line.find("//") != std::string::npos) {
-                    // Format: f 1//1 2//1 3//1
-                    iss >> face.v1;
-                    iss.ignore(); // Ignore '/'
-                    if (iss.peek() == '/') {
-                        face.v2 = 0; // Assign zero to vt1
-                        iss.ignore(); // Ignore '/'
-                        iss >> face.v3;
-                    } else {
-                        face.v2 = 0; // Assign zero to vt1
-                        iss.ignore(); // Ignore '/'
-                        iss >> face.v3;
-                    }
-                } else if (line.find("/") != std::string::npos) {
-                    // Format: f 5/1/1 1/2/1 4/3/1
-                    iss >> face.v1;
-                    iss.ignore(); // Ignore '/'
-                    iss >> face.v2;
-                    iss.ignore(); // Ignore '/'
-                    iss >> face.v3;
-                } else {
-                    // Format: f 1 2 3
-                    iss >> face.v1 >> face.v2 >> face.v3;
+            q = parse_float(q, line_end, normal.nx);
+            q = parse_float(q, line_end, normal.ny);
+            parse_float(q, line_end, normal.nz);
+            chunk.normals.push_back(normal);
+        } else if (type == LINE_FACE) {
+            // Como antes, apenas os três primeiros vértices da face são usados.
+            const size_t count[3] = {chunk.vertices.size(), chunk.textureCoords.size(), chunk.normals.size()};
+            for (int j = 0; j < 3; j++) {
+                const uint32_t slot = static_cast<uint32_t>(chunk.indices[0].size());
+                int index[3];
+                bool relative[3], present[3];
+                q = parse_corner(q, line_end, count, index, relative, present);
+                for (int k = 0; k < 3; k++) {
+                    if (relative[k])
+                        chunk.relative[k].push_back(slot);
+                    chunk.used[k] |= present[k];
+                    chunk.indices[k].push_back(index[k]);
                 }
-
-                faces_in_line.push_back(face);
             }
-            faces.push_back(faces_in_line);
         }
+
+        p = line_end + 1;
+    }
+}
+
+/**
+ * @brief Acrescenta um elemento a um vetor sem que os vetores guardados ultrapassem `limit` bytes.
+ *
+ * A capacidade dobra enquanto couber; perto do limite, cresce apenas o que falta. Durante a
+ * realocação o bloco antigo e o novo coexistem, então os dois são contados.
+ *
+ * @param v Vetor.
+ * @param value Elemento.
+ * @param used Bytes ocupados por todos os vetores guardados (atualizado).
+ * @param limit Máximo de bytes.
+ * @return false se não houver memória para mais um elemento.
+ */
+template <typename T>
+bool push_bounded(std::vector<T>& v, const T& value, size_t& used, size_t limit) {
+    if (v.size() == v.capacity()) {
+        const size_t available = limit > used ? (limit - used) / sizeof(T) : 0;
+        const size_t capacity = std::min(std::max<size_t>(2 * v.capacity(), 1024), available);
+        if (capacity <= v.capacity())
+            return false;
+        used += (capacity - v.capacity()) * sizeof(T);
+        v.reserve(capacity);
     }
+    v.push_back(value);
+    return true;
+}
 
-    file.close();
+/**
+ * @brief Move os elementos de um bloco para a posição `offset` do vetor de saída.
+ */
+template <typename T>
+void move_into(std::vector<T>& source, std::vector<T>& destination, size_t offset) {
+    std::move(source.begin(), source.end(), destination.begin() + offset);
+    std::vector<T>().swap(source);
 }
 
+} // namespace
+
+void ObjLoader::LoadObj(const std::string& filename) {
+    vertices.clear();
+    textureCoords.clear();
+    normals.clear();
+    positionIndices.clear();
+    textureCoordIndices.clear();
+    normalIndices.clear();
+    cache.reset();
 
+    if (use_cache) {
+        cache = open_mesh_cache(filename, cache_element_size);
+        if (cache)
+            return;
+    }
 
-std::vector<triangle> ObjLoader::get_triangle_faces(shared_ptr<material> mat) {
+    MappedFile file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir o arquivo: " << filename << std::endl;
+        return;
+    }
+    ParseObj(file);
+
+    if (use_cache) {
+        const MeshCacheArray arrays[MESH_CACHE_ARRAYS] = {
+            {vertices.data(), vertices.size(), sizeof(Vertex)},
+            {textureCoords.data(), textureCoords.size(), sizeof(TextureCoord)},
+            {normals.data(), normals.size(), sizeof(Normal)},
+            {positionIndices.data(), positionIndices.size(), sizeof(int)},
+            {textureCoordIndices.data(), textureCoordIndices.size(), sizeof(int)},
+            {normalIndices.data(), normalIndices.size(), sizeof(int)},
+        };
+        write_mesh_cache(filename, file, arrays);
+    }
+}
+
+void ObjLoader::ParseObj(const MappedFile& file) {
+    // Divide o arquivo em blocos que terminam em uma quebra de linha; há mais blocos do que
+    // threads para que o roubo de trabalho equilibre trechos com muitas faces.
+    int thread_count = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    thread_count = std::max(thread_count, 1);
+    const size_t min_chunk_size = 256 * 1024;
+    const size_t chunk_count = std::max<size_t>(1, std::min<size_t>(file.size() / min_chunk_size, 4 * thread_count));
+
+    const char* const file_begin = file.data();
+    const char* const file_end = file_begin + file.size();
+    std::vector<const char*> bounds(chunk_count + 1, file_end);
+    bounds[0] = file_begin;
+    for (size_t c = 1; c < chunk_count; c++) {
+        const char* p = std::max(bounds[c - 1], file_begin + file.size() * c / chunk_count);
+        const char* newline = p < file_end ? static_cast<const char*>(std::memchr(p, '\n', file_end - p)) : nullptr;
+        bounds[c] = newline != nullptr ? newline + 1 : file_end;
+    }
+
+    std::vector<ObjChunk> chunks(chunk_count);
+    parallel_for_tasks(static_cast<int>(chunk_count), thread_count, [&](int c, int) {
+        parse_chunk(bounds[c], bounds[c + 1], chunks[c]);
+    });
+
+    // Somas de prefixo: posição de cada bloco nos vetores de saída.
+    struct Offsets { size_t vertices, textureCoords, normals, indices; };
+    std::vector<Offsets> offsets(chunk_count);
+    Offsets total = {0, 0, 0, 0};
+    bool used[3] = {false, false, false};
+    for (size_t c = 0; c < chunk_count; c++) {
+        offsets[c] = total;
+        total.vertices += chunks[c].vertices.size();
+        total.textureCoords += chunks[c].textureCoords.size();
+        total.normals += chunks[c].normals.size();
+        total.indices += chunks[c].indices[0].size();
+        for (int k = 0; k < 3; k++)
+            used[k] |= chunks[c].used[k];
+    }
+    vertices.resize(total.vertices);
+    textureCoords.resize(total.textureCoords);
+    normals.resize(total.normals);
+    // Atributos que nenhuma face usa não ocupam memória.
+    std::vector<int>* const indices[3] = {&positionIndices, &textureCoordIndices, &normalIndices};
+    for (int k = 0; k < 3; k++)
+        if (k == 0 || used[k])
+            indices[k]->resize(total.indices);
+
+    parallel_for_tasks(static_cast<int>(chunk_count), thread_count, [&](int c, int) {
+        ObjChunk& chunk = chunks[c];
+        const Offsets& base = offsets[c];
+        // Índices relativos foram convertidos apenas com os elementos do próprio bloco.
+        const size_t base_count[3] = {base.vertices, base.textureCoords, base.normals};
+        for (int k = 0; k < 3; k++)
+            for (uint32_t slot : chunk.relative[k])
+                chunk.indices[k][slot] += static_cast<int>(base_count[k]);
+
+        move_into(chunk.vertices, vertices, base.vertices);
+        move_into(chunk.textureCoords, textureCoords, base.textureCoords);
+        move_into(chunk.normals, normals, base.normals);
+        for (int k = 0; k < 3; k++) {
+            if (indices[k]->empty())
+                std::vector<int>().swap(chunk.indices[k]);
+            else
+                move_into(chunk.indices[k], *indices[k], base.indices);
+        }
+    });
+}
+
+bool ObjLoader::StreamObj(const std::string& filename, material_id mat,
+                          const std::function<void(Span<const triangle>)>& callback) const {
+    // Divisão do orçamento: 1/8 para a janela de leitura, 1/8 para o lote de triângulos e o
+    // restante para as posições e normais.
+    const size_t window_size = std::min<size_t>(std::max<size_t>(stream_memory_budget / 8, 4096), 16 << 20);
+    const size_t batch_size = std::max<size_t>(stream_memory_budget / 8 / sizeof(triangle), 1);
+    const size_t window_and_batch = window_size + batch_size * sizeof(triangle);
+    if (stream_memory_budget <= window_and_batch) {
+        std::cerr << "Orçamento de memória muito pequeno para ler o arquivo: " << filename << std::endl;
+        return false;
+    }
+    const size_t attribute_limit = stream_memory_budget - window_and_batch;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao abrir o arquivo: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<char> window(window_size);
+    std::vector<triangle> batch;
+    batch.reserve(batch_size);
+    std::vector<Vertex> positions;
+    std::vector<Normal> normal_list;
+    size_t attribute_bytes = 0;
+    size_t texture_coord_count = 0;
+
+    // Lê as linhas completas de [p, end); devolve false se faltar memória.
+    auto process = [&](const char* p, const char* const end) {
+        while (p < end) {
+            const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (line_end == nullptr)
+                line_end = end;
+
+            const char* q;
+            const LineType type = line_type(p, line_end, q);
+            if (type == LINE_VERTEX) {
+                Vertex vertex;
+                q = parse_float(q, line_end, vertex.x);
+                q = parse_float(q, line_end, vertex.y);
+                parse_float(q, line_end, vertex.z);
+                if (!push_bounded(positions, vertex, attribute_bytes, attribute_limit))
+                    return false;
+            } else if (type == LINE_TEXTURE_COORD) {
+                // As coordenadas de textura não fazem parte dos triângulos; só a quantidade importa.
+                texture_coord_count++;
+            } else if (type == LINE_NORMAL) {
+                Normal normal;
+                q = parse_float(q, line_end, normal.nx);
+                q = parse_float(q, line_end, normal.ny);
+                parse_float(q, line_end, normal.nz);
+                if (!push_bounded(normal_list, normal, attribute_bytes, attribute_limit))
+                    return false;
+            } else if (type == LINE_FACE) {
+                const size_t count[3] = {positions.size(), texture_coord_count, normal_list.size()};
+                point3 P[3];
+                vec3 N[3];
+                bool has_normals = false;
+                for (int j = 0; j < 3; j++) {
+                    int index[3];
+                    bool relative[3], present[3];
+                    q = parse_corner(q, line_end, count, index, relative, present);
+                    const Vertex v = element_or_zero(Span<const Vertex>(positions), index[0]);
+                    const Normal n = element_or_zero(Span<const Normal>(normal_list), index[2]);
+                    P[j] = point3(v.x, v.y, v.z);
+                    N[j] = vec3(n.nx, n.ny, n.nz);
+                    has_normals |= present[2];
+                }
+
+                if (!has_normals) {
+                    vec3 triangle_normal = cross(P[1] - P[0], P[2] - P[0]);
+                    N[0] = N[1] = N[2] = triangle_normal;
+                }
+                batch.push_back(triangle(vertex(P[0], N[0]), vertex(P[1], N[1]), vertex(P[2], N[2]), mat));
+                if (batch.size() == batch_size) {
+                    callback(Span<const triangle>(batch));
+                    batch.clear();
+                }
+            }
+
+            p = line_end + 1;
+        }
+        return true;
+    };
+
+    // Cada janela é processada até a última quebra de linha; o resto da última linha, incompleta,
+    // é levado para o início da próxima janela.
+    size_t filled = 0;
+    while (true) {
+        file.read(window.data() + filled, static_cast<std::streamsize>(window_size - filled));
+        const size_t end = filled + static_cast<size_t>(file.gcount());
+        if (end == 0)
+            break;
+        const bool last = end < window_size;
+
+        size_t lines_end = end;
+        if (!last) {
+            while (lines_end > 0 && window[lines_end - 1] != '\n')
+                lines_end--;
+            if (lines_end == 0) {
+                std::cerr << "Linha maior que a janela de leitura em: " << filename << std::endl;
+                return false;
+            }
+        }
+
+        if (!process(window.data(), window.data() + lines_end)) {
+            std::cerr << "Orçamento de memória insuficiente para as posições e normais de: " << filename << std::endl;
+            return false;
+        }
+        filled = end - lines_end;
+        std::memmove(window.data(), window.data() + lines_end, filled);
+        if (last)
+            break;
+    }
+
+    if (!batch.empty())
+        callback(Span<const triangle>(batch));
+    return true;
+}
+
+std::vector<triangle> ObjLoader::get_triangle_faces(material_id mat) {
         /* Collect all triangles from obj */
         std::vector<triangle> triangle_list;
-        int qtd_faces = faces.size();
+        Span<const Vertex> vertex_span = GetVertexSpan();
+        Span<const Normal> normal_span = GetNormalSpan();
+        Span<const int> position_index = GetPositionIndexSpan();
+        Span<const int> normal_index = GetNormalIndexSpan();
+        const size_t qtd_faces = GetFaceCount();
+        triangle_list.reserve(qtd_faces);
 
         for (size_t i = 0; i < qtd_faces; i++) {
-            int indiceV0 = this->GetFaces(i, 0).v1 - 1;
-            int indiceV1 = this->GetFaces(i, 1).v1 - 1;
-            int indiceV2 = this->GetFaces(i, 2).v1 - 1;
-
-            point3 A(this->GetVertices(indiceV0).x, this->GetVertices(indiceV0).y, this->GetVertices(indiceV0).z);
-            point3 B(this->GetVertices(indiceV1).x, this->GetVertices(indiceV1).y, this->GetVertices(indiceV1).z);
-            point3 C(this->GetVertices(indiceV2).x, this->GetVertices(indiceV2).y, this->GetVertices(indiceV2).z);
+            point3 P[3];
+            for (int j = 0; j < 3; j++) {
+                const Vertex v = element_or_zero(vertex_span, position_index[3 * i + j]);
+                P[j] = point3(v.x, v.y, v.z);
+            }
 
             // If the obj file doesn't specify vertex normals...
-            if(normals.empty()) {
-                vec3 u = B - A;
-                vec3 v = C - A;
-                vec3 triangle_normal = cross(u, v);
+            if (normal_span.empty() || normal_index.empty()) {
+                vec3 triangle_normal = cross(P[1] - P[0], P[2] - P[0]);
 
-                vertex vA(A, triangle_normal), vB(B, triangle_normal), vC(C, triangle_normal);
-                triangle t = triangle(vA, vB, vC, mat);
-                triangle_list.push_back(t);
+                vertex vA(P[0], triangle_normal), vB(P[1], triangle_normal), vC(P[2], triangle_normal);
+                triangle_list.push_back(triangle(vA, vB, vC, mat));
 
             } else {
-                int ind_vnA = this->GetFaces(i, 0).v3 - 1;
-                int ind_vnB = this->GetFaces(i, 1).v3 - 1;
-                int ind_vnC = this->GetFaces(i, 2).v3 - 1;
-                point3 normal_A(this->GetNormals(ind_vnA).nx, this->GetNormals(ind_vnA).ny, this->GetNormals(ind_vnA).nz);
-                point3 normal_B(this->GetNormals(ind_vnB).nx, this->GetNormals(ind_vnB).ny, this->GetNormals(ind_vnB).nz);
-                point3 normal_C(this->GetNormals(ind_vnC).nx, this->GetNormals(ind_vnC).ny, this->GetNormals(ind_vnC).nz);
-
-                vertex vA(A, normal_A), vB(B, normal_B), vC(C, normal_C);
-                triangle t = triangle(vA, vB, vC, mat);
-                triangle_list.push_back(t);
+                vec3 N[3];
+                for (int j = 0; j < 3; j++) {
+                    const Normal n = element_or_zero(normal_span, normal_index[3 * i + j]);
+                    N[j] = vec3(n.nx, n.ny, n.nz);
+                }
+
+                vertex vA(P[0], N[0]), vB(P[1], N[1]), vC(P[2], N[2]);
+                triangle_list.push_back(triangle(vA, vB, vC, mat));
             }
         }
 
         return triangle_list;
-    }
\ No newline at end of file
+    }
+
+shared_ptr<mesh_data> ObjLoader::get_mesh_data() const {
+    auto mesh = make_shared<mesh_data>();
+    Span<const Vertex> vertex_span = GetVertexSpan();
+    Span<const Normal> normal_span = GetNormalSpan();
+    Span<const int> position_index = GetPositionIndexSpan();
+    Span<const int> normal_index = GetNormalIndexSpan();
+
+    mesh->positions.reserve(vertex_span.size() * 3);
+    for (const Vertex& vertex : vertex_span) {
+        mesh->positions.push_back(vertex.x);
+        mesh->positions.push_back(vertex.y);
+        mesh->positions.push_back(vertex.z);
+    }
+
+    mesh->normals.reserve(normal_span.size() * 3);
+    for (const Normal& normal : normal_span) {
+        mesh->normals.push_back(normal.nx);
+        mesh->normals.push_back(normal.ny);
+        mesh->normals.push_back(normal.nz);
+    }
+
+    // Os índices são conferidos uma vez aqui, para que o `triangle_mesh` possa usá-los sem
+    // verificação: faces com alguma posição inválida são descartadas, e faces com alguma normal
+    // ausente ou inválida recebem a normal do plano, acrescentada ao fim do vetor de normais.
+    const bool use_normals = !normal_span.empty() && !normal_index.empty();
+    auto valid = [](int index, size_t count) { return static_cast<size_t>(index) < count; };
+    const size_t qtd_faces = GetFaceCount();
+    mesh->position_indices.reserve(3 * qtd_faces);
+    if (use_normals)
+        mesh->normal_indices.reserve(3 * qtd_faces);
+
+    for (size_t i = 0; i < qtd_faces; i++) {
+        const int* p = &position_index[3 * i];
+        if (!valid(p[0], vertex_span.size()) || !valid(p[1], vertex_span.size()) || !valid(p[2], vertex_span.size()))
+            continue;
+        for (int j = 0; j < 3; j++)
+            mesh->position_indices.push_back(static_cast<uint32_t>(p[j]));
+        if (!use_normals)
+            continue;
+
+        const int* n = &normal_index[3 * i];
+        if (valid(n[0], normal_span.size()) && valid(n[1], normal_span.size()) && valid(n[2], normal_span.size())) {
+            for (int j = 0; j < 3; j++)
+                mesh->normal_indices.push_back(static_cast<uint32_t>(n[j]));
+        } else {
+            const point3 a = mesh->position(p[0]), b = mesh->position(p[1]), c = mesh->position(p[2]);
+            const vec3 face_normal = cross(b - a, c - a);
+            const uint32_t index = static_cast<uint32_t>(mesh->normals.size() / 3);
+            for (int k = 0; k < 3; k++)
+                mesh->normals.push_back(static_cast<float>(face_normal[k]));
+            for (int j = 0; j < 3; j++)
+                mesh->normal_indices.push_back(index);
+        }
+    }
+
+    return mesh;
+}
@@ -8,12 +8,16 @@
 
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <vector>
 #include <string>
 
-#include "../../Atividade05/includes/Triangle.h"
-#include "../../Atividade05/includes/Material.h"
+#include "../../Atividade05/includes/triangle.h"
+#include "../../Atividade05/includes/material.h"
+#include "../../Atividade05/includes/triangle_mesh.h"
+#include "MappedFile.h"
+#include "Span.h"
 
 /**
  * @brief Estrutura para representar um vértice.
@@ -37,21 +41,32 @@ struct Normal {
 };
 
 /**
- * @brief Estrutura para representar uma face.
+ * @brief Estrutura para representar um vértice de uma face, com os índices do arquivo OBJ.
+ *
+ * Os índices começam em 1, e 0 indica um índice ausente. Os dados são guardados em vetores
+ * separados por atributo (veja `GetPositionIndexSpan`); esta estrutura é montada apenas por `GetFaces`.
  */
 struct Face {
-    int v1, v2, v3;
+    int v1; ///< Índice da posição.
+    int v2; ///< Índice da coordenada de textura.
+    int v3; ///< Índice da normal.
 };
 
 /**
  * @brief Classe para carregamento de arquivos no formato OBJ.
+ *
+ * Depois da primeira leitura de um arquivo `modelo.obj`, os dados são gravados em
+ * `modelo.obj.meshcache` (veja `MeshCache.h`). Nas leituras seguintes, se o OBJ não mudou, o cache
+ * é mapeado em memória e os vértices, normais e índices das faces são acessados diretamente nele,
+ * sem cópias.
+ * Por isso os dados são expostos como visões (`Span`), válidas enquanto o `ObjLoader` existir e
+ * não carregar outro arquivo.
  */
 class ObjLoader {
 public:
-    std::vector<Vertex> vertices; ///< Vetor de vértices.
-    std::vector<TextureCoord> textureCoords; ///< Vetor de coordenadas de textura.
-    std::vector<Normal> normals; ///< Vetor de normais.
-    std::vector<std::vector<Face>> faces; ///< Vetor de faces.
+    int threads = 0; ///< Número de threads de leitura (0 = todos os núcleos).
+    bool use_cache = true; ///< Se o cache binário deve ser lido e gravado ao lado do arquivo OBJ.
+    size_t stream_memory_budget = 64 << 20; ///< Memória máxima, em bytes, usada por `StreamObj`.
 
     /**
      * @brief Obtém os vértices carregados.
@@ -82,17 +97,127 @@ public:
     Face GetFaces(const int i, const int j) const;
 
     /**
-     * @brief Carrega um arquivo OBJ.
+     * @brief Obtém todos os vértices, sem cópia.
+     * @return Visão dos vértices.
+     */
+    Span<const Vertex> GetVertexSpan() const;
+
+    /**
+     * @brief Obtém todas as coordenadas de textura, sem cópia.
+     * @return Visão das coordenadas de textura.
+     */
+    Span<const TextureCoord> GetTextureCoordSpan() const;
+
+    /**
+     * @brief Obtém todas as normais, sem cópia.
+     * @return Visão das normais.
+     */
+    Span<const Normal> GetNormalSpan() const;
+
+    /**
+     * @brief Obtém o índice da posição de cada vértice das faces, sem cópia.
+     *
+     * Três índices consecutivos por face, começando em 0 (ao contrário do arquivo OBJ); -1 indica
+     * um índice ausente.
+     *
+     * @return Visão dos índices de posição.
+     */
+    Span<const int> GetPositionIndexSpan() const;
+
+    /**
+     * @brief Obtém o índice da coordenada de textura de cada vértice das faces, sem cópia.
+     * @return Visão dos índices, no mesmo formato de `GetPositionIndexSpan`, ou vazia se nenhuma
+     * face usa coordenadas de textura.
+     */
+    Span<const int> GetTextureCoordIndexSpan() const;
+
+    /**
+     * @brief Obtém o índice da normal de cada vértice das faces, sem cópia.
+     * @return Visão dos índices, no mesmo formato de `GetPositionIndexSpan`, ou vazia se nenhuma
+     * face usa normais.
+     */
+    Span<const int> GetNormalIndexSpan() const;
+
+    /**
+     * @brief Obtém a quantidade de faces carregadas.
+     * @return Quantidade de faces.
+     */
+    size_t GetFaceCount() const { return GetPositionIndexSpan().size() / 3; }
+
+    /**
+     * @brief Indica se os dados atuais vieram do cache binário.
+     * @return true se o último `LoadObj` usou o cache.
+     */
+    bool IsCached() const { return cache != nullptr; }
+
+    /**
+     * @brief Carrega um arquivo OBJ, substituindo os dados carregados anteriormente.
+     *
+     * Se houver um cache válido ao lado do arquivo, ele é usado; caso contrário, o arquivo é
+     * dividido em blocos que terminam em quebras de linha, lidos em paralelo por `threads`
+     * threads, e o cache é gravado para as próximas leituras. Os elementos de cada bloco são
+     * copiados para a posição dada pela soma das quantidades dos blocos anteriores, então o
+     * resultado é o mesmo para qualquer número de threads, inclusive com índices relativos
+     * (negativos).
+     *
      * @param filename Nome do arquivo OBJ.
      */
     void LoadObj(const std::string& filename);
 
+    /**
+     * @brief Lê um arquivo OBJ em janelas de tamanho fixo, entregando os triângulos em lotes.
+     *
+     * Para arquivos que não cabem na memória depois de expandidos: as faces são convertidas em
+     * triângulos assim que lidas e nunca são guardadas, e apenas as posições e normais lidas até o
+     * momento são mantidas para resolver os índices. A janela de leitura, o lote de triângulos e os
+     * vetores de posições e normais ficam dentro de `stream_memory_budget` bytes. Os triângulos são
+     * os mesmos de `get_triangle_faces`, exceto que uma face sem índices de normal usa a normal do
+     * plano mesmo que o arquivo tenha normais, e índices de elementos definidos mais adiante no
+     * arquivo (o formato não os proíbe, mas são raros) são tratados como inválidos. Não usa nem
+     * altera os dados carregados por `LoadObj`.
+     *
+     * @param filename Nome do arquivo OBJ.
+     * @param mat Material para os triângulos.
+     * @param callback Função chamada com cada lote, na ordem do arquivo; a visão só é válida
+     * durante a chamada.
+     * @return false se o arquivo não puder ser aberto, se uma linha não couber na janela ou se as
+     * posições e normais não couberem no orçamento de memória; nesse caso, os lotes já entregues
+     * correspondem ao trecho lido até a falha.
+     */
+    bool StreamObj(const std::string& filename, material_id mat,
+                   const std::function<void(Span<const triangle>)>& callback) const;
+
     /**
      * @brief Obtém as faces do objeto como triângulos.
      * @param mat Material para os triângulos.
      * @return Vetor de triângulos.
      */
-    std::vector<Triangle> GetTriangleFaces(std::shared_ptr<Material> mat);
+    std::vector<triangle> get_triangle_faces(material_id mat);
+
+    /**
+     * @brief Obtém o objeto como uma malha indexada, sem duplicar vértices.
+     *
+     * Faces com algum índice de posição ausente ou fora do intervalo são descartadas; faces com
+     * algum índice de normal ausente ou fora do intervalo usam a normal do plano.
+     *
+     * @return Buffers de posições, normais e índices, prontos para um `triangle_mesh`.
+     */
+    shared_ptr<mesh_data> get_mesh_data() const;
+
+private:
+    std::vector<Vertex> vertices; ///< Vetor de vértices (lidos do texto).
+    std::vector<TextureCoord> textureCoords; ///< Vetor de coordenadas de textura (lidas do texto).
+    std::vector<Normal> normals; ///< Vetor de normais (lidas do texto).
+    std::vector<int> positionIndices; ///< Índices de posição, três por face (lidos do texto).
+    std::vector<int> textureCoordIndices; ///< Índices de coordenada de textura (vazio se não usados).
+    std::vector<int> normalIndices; ///< Índices de normal (vazio se não usados).
+    shared_ptr<const MappedFile> cache; ///< Cache mapeado em memória, quando usado.
+
+    /**
+     * @brief Lê o texto do arquivo OBJ para os vetores.
+     * @param file Conteúdo do arquivo.
+     */
+    void ParseObj(const MappedFile& file);
 };
 
-#endif 
+#endif
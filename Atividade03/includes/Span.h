@@ -0,0 +1,50 @@
+/**
+ * @file Span.h
+ * @brief Visão somente leitura de um trecho contíguo de memória.
+ * @author Martin Henrique Viana Adam
+ */
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Ponteiro e quantidade de elementos, com a mesma interface básica de `std::span` (C++20).
+ *
+ * Permite percorrer os dados carregados pelo `ObjLoader` sem cópias, estejam eles em um
+ * `std::vector` ou diretamente em um arquivo mapeado em memória. A visão não é dona dos dados:
+ * ela é válida enquanto o objeto que a devolveu existir e não for modificado.
+ */
+template <typename T>
+class Span {
+public:
+    Span() = default;
+
+    /**
+     * @brief Cria uma visão de `count` elementos a partir de `first`.
+     * @param first Primeiro elemento.
+     * @param count Quantidade de elementos.
+     */
+    Span(T* first, size_t count) : first(first), count(count) {}
+
+    /**
+     * @brief Cria uma visão de todos os elementos de um vetor.
+     * @param v Vetor.
+     */
+    template <typename U>
+    Span(const std::vector<U>& v) : first(v.data()), count(v.size()) {}
+
+    T* data() const { return first; } ///< Primeiro elemento.
+    size_t size() const { return count; } ///< Quantidade de elementos.
+    bool empty() const { return count == 0; } ///< Indica se a visão não tem elementos.
+    T* begin() const { return first; } ///< Início, para laços `for` por intervalo.
+    T* end() const { return first + count; } ///< Fim, para laços `for` por intervalo.
+    T& operator[](size_t i) const { return first[i]; } ///< Elemento `i`, sem verificação de limites.
+
+private:
+    T* first = nullptr;
+    size_t count = 0;
+};
+
+#endif
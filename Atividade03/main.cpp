@@ -16,7 +16,7 @@ int main() {
     objLoader.LoadObj("/caminho/do/arquivo/indoor_plant.obj");
 
     // Imprime os vértices
-    for (size_t i = 0; i < objLoader.vertices.size(); ++i) {
+    for (size_t i = 0; i < objLoader.GetVertexSpan().size(); ++i) {
         Vertex vertex = objLoader.GetVertices(i);
         std::cout << "Vértice " << i << ": " << vertex.x << " " << vertex.y << " " << vertex.z << std::endl;
     }
@@ -29,14 +29,14 @@ int main() {
     }
 
     // Imprime as normais
-    for (size_t i = 0; i < objLoader.normals.size(); ++i) {
+    for (size_t i = 0; i < objLoader.GetNormalSpan().size(); ++i) {
         Normal normal = objLoader.GetNormals(i);
         std::cout << "Normal " << i << ": " << normal.nx << " " << normal.ny << " " << normal.nz << std::endl;
     }
 
     // Imprime as faces
-    for (size_t i = 0; i < objLoader.faces.size(); ++i) {
-        for (size_t j = 0; j < objLoader.faces[i].size(); ++j) {
+    for (size_t i = 0; i < objLoader.GetFaceCount(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
             Face face = objLoader.GetFaces(i, j);
             std::cout << "Face " << i << ", Vértice " << j << ": " << face.v1 << " " << face.v2 << " " << face.v3 << std::endl;
         }
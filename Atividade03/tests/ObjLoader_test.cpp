@@ -1,18 +1,39 @@
 #include "gtest/gtest.h"
 #include "../includes/ObjLoader.h"
+#include "../includes/MeshCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Caminho de um arquivo da pasta dos testes, independente do diretório de execução.
+static std::string test_path(const std::string& name) {
+    std::string dir = __FILE__;
+    return dir.substr(0, dir.find_last_of("/\\") + 1) + name;
+}
+
+// Escreve um arquivo OBJ temporário com o conteúdo dado.
+static std::string write_obj(const std::string& name, const std::string& contents) {
+    std::string path = ::testing::TempDir() + name;
+    std::ofstream(path, std::ios::binary) << contents;
+    return path;
+}
 
 TEST(ObjLoaderTest, LoadObj) {
     ObjLoader objLoader;
-    objLoader.LoadObj("/Users/renanoliveira/Desktop/ufscar/Faculdade/Computacao Grafica/2023/Atividade03/tests/mock/mock.obj");
+    objLoader.use_cache = false;
+    objLoader.LoadObj(test_path("mock/mock.obj"));
 
     // Testar o número de vértices, coordenadas de textura, normais e faces
-    ASSERT_EQ(objLoader.GetVertices().size(), 3);
+    ASSERT_EQ(objLoader.GetVertexSpan().size(), 3);
     ASSERT_EQ(objLoader.GetTextureCoords().size(), 3);
-    ASSERT_EQ(objLoader.GetNormals().size(), 3);
-    ASSERT_EQ(objLoader.GetFaces().size(), 1);
+    ASSERT_EQ(objLoader.GetNormalSpan().size(), 3);
+    ASSERT_EQ(objLoader.GetFaceCount(), 1);
 
     // Testar os valores de alguns vértices, coordenadas de textura, normais e faces
-    Vertex vertex = objLoader.GetVertices()[0];
+    Vertex vertex = objLoader.GetVertices(0);
     ASSERT_FLOAT_EQ(vertex.x, 1.0);
     ASSERT_FLOAT_EQ(vertex.y, 0.0);
     ASSERT_FLOAT_EQ(vertex.z, 0.0);
@@ -21,8 +42,378 @@ TEST(ObjLoaderTest, LoadObj) {
     ASSERT_FLOAT_EQ(texCoord.u, 0.0);
     ASSERT_FLOAT_EQ(texCoord.v, 0.0);
 
-    Normal normal = objLoader.GetNormals()[0];
+    Normal normal = objLoader.GetNormals(0);
     ASSERT_FLOAT_EQ(normal.nx, 1.0);
     ASSERT_FLOAT_EQ(normal.ny, 1.0);
     ASSERT_FLOAT_EQ(normal.nz, 1.0);
+
+    Face face = objLoader.GetFaces(0, 2);
+    ASSERT_EQ(face.v1, 3);
+    ASSERT_EQ(face.v2, 3);
+    ASSERT_EQ(face.v3, 3);
+}
+
+TEST(ObjLoaderTest, FaceFormats) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(write_obj("formats.obj",
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n"
+        "f 1 2 3\n"
+        "f 1/1 2/2 3/3\n"
+        "f 1//1 2//1 3//1\n"
+        "f 1/3/1 2/2/1 3/1/1\n"));
+
+    ASSERT_EQ(objLoader.GetFaceCount(), 4);
+    EXPECT_EQ(objLoader.GetFaces(0, 1).v1, 2);
+    EXPECT_EQ(objLoader.GetFaces(0, 1).v2, 0);
+    EXPECT_EQ(objLoader.GetFaces(0, 1).v3, 0);
+    EXPECT_EQ(objLoader.GetFaces(1, 2).v1, 3);
+    EXPECT_EQ(objLoader.GetFaces(1, 2).v2, 3);
+    EXPECT_EQ(objLoader.GetFaces(1, 2).v3, 0);
+    EXPECT_EQ(objLoader.GetFaces(2, 0).v1, 1);
+    EXPECT_EQ(objLoader.GetFaces(2, 0).v2, 0);
+    EXPECT_EQ(objLoader.GetFaces(2, 0).v3, 1);
+    EXPECT_EQ(objLoader.GetFaces(3, 0).v2, 3);
+    EXPECT_EQ(objLoader.GetFaces(3, 2).v2, 1);
+}
+
+TEST(ObjLoaderTest, RelativeIndices) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(write_obj("relative.obj",
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+        "f -3//-1 -2//-1 -1//-1\n"
+        "v 1 1 0\n"
+        "f -3 -2 -1\n"));
+
+    ASSERT_EQ(objLoader.GetFaceCount(), 2);
+    EXPECT_EQ(objLoader.GetFaces(0, 0).v1, 1);
+    EXPECT_EQ(objLoader.GetFaces(0, 2).v1, 3);
+    EXPECT_EQ(objLoader.GetFaces(0, 2).v3, 1);
+    EXPECT_EQ(objLoader.GetFaces(1, 0).v1, 2);
+    EXPECT_EQ(objLoader.GetFaces(1, 2).v1, 4);
+}
+
+TEST(ObjLoaderTest, ParallelLoadMatchesSingleThread) {
+    // ~3 MB: vários blocos por thread, com índices relativos que cruzam as fronteiras dos blocos.
+    std::string contents = "vn 0 0 1\nvt 0 0\n";
+    for (int i = 0; i < 40000; i++) {
+        contents += "v " + std::to_string(i) + " 0.5 -1.25\nv 0 " + std::to_string(i) + " 2\nv 1 1 " + std::to_string(i) + "\n";
+        contents += "f -3/-1/-1 -2/1/1 -1/-1/-1\n";
+        contents += "f " + std::to_string(3 * i + 1) + " " + std::to_string(3 * i + 2) + " " + std::to_string(3 * i + 3) + "\n";
+    }
+    std::string path = write_obj("parallel.obj", contents);
+
+    ObjLoader single, parallel;
+    single.threads = 1;
+    parallel.threads = 8;
+    single.use_cache = parallel.use_cache = false;
+    single.LoadObj(path);
+    parallel.LoadObj(path);
+
+    ASSERT_EQ(parallel.GetVertexSpan().size(), 120000);
+    ASSERT_EQ(parallel.GetFaceCount(), 80000);
+    for (size_t i = 0; i < parallel.GetVertexSpan().size(); i++) {
+        EXPECT_EQ(parallel.GetVertexSpan()[i].x, single.GetVertexSpan()[i].x);
+        EXPECT_EQ(parallel.GetVertexSpan()[i].y, single.GetVertexSpan()[i].y);
+        EXPECT_EQ(parallel.GetVertexSpan()[i].z, single.GetVertexSpan()[i].z);
+    }
+    for (size_t i = 0; i < parallel.GetFaceCount(); i++) {
+        for (int j = 0; j < 3; j++) {
+            Face face = parallel.GetFaces(i, j);
+            ASSERT_EQ(face.v1, static_cast<int>(3 * (i / 2) + j + 1));
+            ASSERT_EQ(face.v1, single.GetFaces(i, j).v1);
+            ASSERT_EQ(face.v2, single.GetFaces(i, j).v2);
+            ASSERT_EQ(face.v3, single.GetFaces(i, j).v3);
+        }
+    }
+    EXPECT_EQ(parallel.GetFaces(2, 0).v2, 1);
+    EXPECT_EQ(parallel.GetFaces(2, 0).v3, 1);
+
+    // Blocos sem nenhum `vn` próprio: -1 se refere ao último elemento de um bloco anterior e não
+    // pode ser confundido com um índice ausente.
+    std::string relative_only = "vn 0 0 1\nv 0 0 0\nv 1 0 0\nv 0 1 0\n# " + std::string(600 * 1024, 'x') + "\n";
+    for (int i = 0; i < 60000; i++)
+        relative_only += "f -3//-1 -2//-1 -1//-1\n";
+    path = write_obj("parallel_relative.obj", relative_only);
+    single.LoadObj(path);
+    parallel.threads = 4;
+    parallel.LoadObj(path);
+
+    ASSERT_EQ(single.GetNormalIndexSpan().size(), 180000);
+    ASSERT_EQ(parallel.GetNormalIndexSpan().size(), 180000);
+    ASSERT_EQ(parallel.GetPositionIndexSpan().size(), 180000);
+    for (size_t i = 0; i < 180000; i++) {
+        ASSERT_EQ(parallel.GetNormalIndexSpan()[i], 0);
+        ASSERT_EQ(parallel.GetPositionIndexSpan()[i], static_cast<int>(i % 3));
+    }
+}
+
+TEST(ObjLoaderTest, IndexSpans) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(write_obj("indices.obj",
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+        "f 1//1 2 -1//-1\n"));
+
+    // Índices começando em 0, um vetor por atributo; -1 onde o índice está ausente.
+    Span<const int> positions = objLoader.GetPositionIndexSpan();
+    Span<const int> normals = objLoader.GetNormalIndexSpan();
+    ASSERT_EQ(positions.size(), 3);
+    EXPECT_EQ(positions[0], 0);
+    EXPECT_EQ(positions[1], 1);
+    EXPECT_EQ(positions[2], 2);
+    ASSERT_EQ(normals.size(), 3);
+    EXPECT_EQ(normals[0], 0);
+    EXPECT_EQ(normals[1], -1);
+    EXPECT_EQ(normals[2], 0);
+
+    // Nenhuma face usa coordenadas de textura: o vetor não é alocado.
+    EXPECT_TRUE(objLoader.GetTextureCoordIndexSpan().empty());
+    EXPECT_EQ(objLoader.GetFaces(0, 1).v2, 0);
+    EXPECT_EQ(objLoader.GetFaces(0, 1).v3, 0);
+    EXPECT_EQ(objLoader.GetFaces(0, 2).v3, 1);
+}
+
+TEST(ObjLoaderTest, MeshDataValidatesIndices) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(write_obj("mesh_data.obj",
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+        "f 1//1 2//1 3//1\n"
+        "f 1 2 3\n"
+        "f 1//1 2//7 3//1\n"
+        "f 1//1 9//1 3//1\n"));
+    auto mesh = objLoader.get_mesh_data();
+
+    // A face com a posição 9 é descartada.
+    ASSERT_EQ(mesh->triangle_count(), 3);
+    ASSERT_EQ(mesh->normal_indices.size(), 9);
+    for (uint32_t index : mesh->position_indices)
+        EXPECT_LT(index, mesh->positions.size() / 3);
+    for (uint32_t index : mesh->normal_indices)
+        EXPECT_LT(index, mesh->normals.size() / 3);
+    for (int j = 0; j < 3; j++)
+        EXPECT_EQ(mesh->normal_indices[j], 0u);
+
+    // Faces sem normal, ou com uma normal inválida, recebem a normal do plano.
+    for (size_t t = 1; t < 3; t++) {
+        for (int j = 0; j < 3; j++) {
+            vec3 normal = mesh->normal(mesh->normal_indices[3 * t + j]);
+            EXPECT_EQ(normal.x(), 0);
+            EXPECT_EQ(normal.y(), 0);
+            EXPECT_EQ(normal.z(), 1);
+        }
+    }
+}
+
+TEST(ObjLoaderTest, WhitespaceCommentsAndMissingNewline) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(write_obj("whitespace.obj",
+        "# comentário\r\n"
+        "  v\t1.5 +2 -3e-1\r\n"
+        "vp 9 9 9\r\n"
+        "o objeto\r\n"
+        "\r\n"
+        "vn 0 0 1"));
+
+    ASSERT_EQ(objLoader.GetVertexSpan().size(), 1);
+    EXPECT_FLOAT_EQ(objLoader.GetVertexSpan()[0].x, 1.5f);
+    EXPECT_FLOAT_EQ(objLoader.GetVertexSpan()[0].y, 2.0f);
+    EXPECT_FLOAT_EQ(objLoader.GetVertexSpan()[0].z, -0.3f);
+    ASSERT_EQ(objLoader.GetNormalSpan().size(), 1);
+    EXPECT_FLOAT_EQ(objLoader.GetNormalSpan()[0].nz, 1.0f);
+}
+
+static const char* cache_test_obj =
+    "v 1 2 3\nv 4 5 6\nv 7 8 9\nvt 0.5 0.25\nvn 0 0 1\nf 1/1/1 2/1/1 3/1/1\nf -1//1 -2//1 -3//1\n";
+
+// Compara todos os dados de dois carregamentos.
+static void expect_same_mesh(const ObjLoader& a, const ObjLoader& b) {
+    ASSERT_EQ(a.GetVertexSpan().size(), b.GetVertexSpan().size());
+    ASSERT_EQ(a.GetTextureCoordSpan().size(), b.GetTextureCoordSpan().size());
+    ASSERT_EQ(a.GetNormalSpan().size(), b.GetNormalSpan().size());
+    ASSERT_EQ(a.GetPositionIndexSpan().size(), b.GetPositionIndexSpan().size());
+    ASSERT_EQ(a.GetTextureCoordIndexSpan().size(), b.GetTextureCoordIndexSpan().size());
+    ASSERT_EQ(a.GetNormalIndexSpan().size(), b.GetNormalIndexSpan().size());
+    for (size_t i = 0; i < a.GetVertexSpan().size(); i++) {
+        EXPECT_EQ(a.GetVertexSpan()[i].x, b.GetVertexSpan()[i].x);
+        EXPECT_EQ(a.GetVertexSpan()[i].z, b.GetVertexSpan()[i].z);
+    }
+    EXPECT_EQ(a.GetTextureCoordSpan()[0].u, b.GetTextureCoordSpan()[0].u);
+    EXPECT_EQ(a.GetNormalSpan()[0].nz, b.GetNormalSpan()[0].nz);
+    for (size_t i = 0; i < a.GetPositionIndexSpan().size(); i++) {
+        EXPECT_EQ(a.GetPositionIndexSpan()[i], b.GetPositionIndexSpan()[i]);
+        EXPECT_EQ(a.GetTextureCoordIndexSpan()[i], b.GetTextureCoordIndexSpan()[i]);
+        EXPECT_EQ(a.GetNormalIndexSpan()[i], b.GetNormalIndexSpan()[i]);
+    }
+}
+
+TEST(ObjLoaderTest, CacheRoundTrip) {
+    std::string path = write_obj("cache.obj", cache_test_obj);
+    std::remove(mesh_cache_path(path).c_str());
+
+    ObjLoader parsed, cached;
+    parsed.LoadObj(path);
+    EXPECT_FALSE(parsed.IsCached());
+    cached.LoadObj(path);
+    EXPECT_TRUE(cached.IsCached());
+    expect_same_mesh(parsed, cached);
+    EXPECT_EQ(cached.GetFaces(1, 0).v1, 3);
+}
+
+TEST(ObjLoaderTest, CacheIsInvalidatedWhenObjChanges) {
+    std::string path = write_obj("cache_stale.obj", cache_test_obj);
+    std::remove(mesh_cache_path(path).c_str());
+    ObjLoader first;
+    first.LoadObj(path);
+
+    // Mesmo tamanho, conteúdo diferente e data de modificação posterior.
+    std::string changed = cache_test_obj;
+    changed[2] = '5';
+    write_obj("cache_stale.obj", changed);
+    auto later = std::filesystem::last_write_time(path) + std::chrono::seconds(2);
+    std::filesystem::last_write_time(path, later);
+
+    ObjLoader second;
+    second.LoadObj(path);
+    EXPECT_FALSE(second.IsCached());
+    EXPECT_FLOAT_EQ(second.GetVertices(0).x, 5.0f);
+}
+
+TEST(ObjLoaderTest, CacheIsKeptWhenOnlyMtimeChanges) {
+    std::string path = write_obj("cache_touch.obj", cache_test_obj);
+    std::remove(mesh_cache_path(path).c_str());
+    ObjLoader first;
+    first.LoadObj(path);
+
+    auto later = std::filesystem::last_write_time(path) + std::chrono::seconds(2);
+    std::filesystem::last_write_time(path, later);
+
+    ObjLoader second;
+    second.LoadObj(path);
+    EXPECT_TRUE(second.IsCached());
+    expect_same_mesh(first, second);
+}
+
+TEST(ObjLoaderTest, CorruptCacheIsIgnored) {
+    std::string path = write_obj("cache_corrupt.obj", cache_test_obj);
+    std::remove(mesh_cache_path(path).c_str());
+    ObjLoader first;
+    first.use_cache = false;
+    first.LoadObj(path);
+    {
+        ObjLoader writer;
+        writer.LoadObj(path);
+    }
+
+    // Cache truncado: o cabeçalho indica mais dados do que o arquivo contém.
+    std::filesystem::resize_file(mesh_cache_path(path), sizeof(MeshCacheHeader) + 8);
+
+    ObjLoader second;
+    second.LoadObj(path);
+    EXPECT_FALSE(second.IsCached());
+    expect_same_mesh(first, second);
+}
+
+TEST(ObjLoaderTest, CacheWithMismatchedIndexCountsIsIgnored) {
+    std::string path = write_obj("cache_counts.obj", cache_test_obj);
+    std::remove(mesh_cache_path(path).c_str());
+    ObjLoader first;
+    first.use_cache = false;
+    first.LoadObj(path);
+    {
+        ObjLoader writer;
+        writer.LoadObj(path);
+    }
+
+    // Cabeçalho coerente com o tamanho do arquivo, mas com menos índices de normal do que de posição.
+    MeshCacheHeader header;
+    std::fstream cache(mesh_cache_path(path), std::ios::in | std::ios::out | std::ios::binary);
+    cache.read(reinterpret_cast<char*>(&header), sizeof(header));
+    ASSERT_EQ(header.count[MESH_CACHE_ARRAYS - 1], 6u);
+    header.count[MESH_CACHE_ARRAYS - 1] = 3;
+    cache.seekp(0);
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    cache.close();
+
+    ObjLoader second;
+    second.LoadObj(path);
+    EXPECT_FALSE(second.IsCached());
+    expect_same_mesh(first, second);
+}
+
+// Compara dois triângulos, vértice a vértice.
+static void expect_same_triangle(const triangle& a, const triangle& b) {
+    const vertex* va[3] = {&a.A, &a.B, &a.C};
+    const vertex* vb[3] = {&b.A, &b.B, &b.C};
+    for (int j = 0; j < 3; j++) {
+        for (int k = 0; k < 3; k++) {
+            EXPECT_EQ(va[j]->coord[k], vb[j]->coord[k]);
+            EXPECT_EQ(va[j]->normal[k], vb[j]->normal[k]);
+        }
+    }
+}
+
+TEST(ObjLoaderTest, StreamMatchesGetTriangleFaces) {
+    // ~1,5 MB com janelas de 512 KB: várias janelas, linhas cortadas entre elas e vários lotes.
+    std::string contents;
+    for (int i = 0; i < 20000; i++) {
+        contents += "v " + std::to_string(i) + " 0.5 -1.25\nv 0 " + std::to_string(i) + " 2\nv 1 1 " + std::to_string(i) + "\n";
+        contents += "vn 0 0 " + std::to_string(i % 7) + "\nvt 0.5 0.5\n";
+        contents += "f -3/-1/-1 -2//-1 -1/1/-1\n";
+        contents += "f " + std::to_string(3 * i + 1) + "//1 " + std::to_string(3 * i + 2) + "//" + std::to_string(i + 1) + " " + std::to_string(3 * i + 3) + "//99999999\n";
+    }
+    std::string path = write_obj("stream.obj", contents);
+
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(path);
+    std::vector<triangle> expected = objLoader.get_triangle_faces(7);
+
+    objLoader.stream_memory_budget = 4 << 20;
+    std::vector<triangle> streamed;
+    size_t batches = 0, largest = 0;
+    ASSERT_TRUE(objLoader.StreamObj(path, 7, [&](Span<const triangle> batch) {
+        batches++;
+        largest = std::max(largest, batch.size());
+        streamed.insert(streamed.end(), batch.begin(), batch.end());
+    }));
+
+    EXPECT_GT(batches, 1);
+    EXPECT_LE(largest * sizeof(triangle), objLoader.stream_memory_budget / 8);
+    ASSERT_EQ(streamed.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        expect_same_triangle(streamed[i], expected[i]);
+        EXPECT_EQ(streamed[i].mat, 7);
+    }
+}
+
+TEST(ObjLoaderTest, StreamRespectsMemoryBudget) {
+    std::string contents;
+    for (int i = 0; i < 10000; i++)
+        contents += "v 1 2 3\n";
+    contents += "f 1 2 3\n";
+    std::string path = write_obj("stream_budget.obj", contents);
+
+    // 10000 posições (120 KB) não cabem em um orçamento de 64 KB.
+    ObjLoader objLoader;
+    objLoader.stream_memory_budget = 64 * 1024;
+    size_t triangles = 0;
+    auto count = [&](Span<const triangle> batch) { triangles += batch.size(); };
+    EXPECT_FALSE(objLoader.StreamObj(path, 0, count));
+
+    objLoader.stream_memory_budget = 1 << 20;
+    EXPECT_TRUE(objLoader.StreamObj(path, 0, count));
+    EXPECT_EQ(triangles, 1);
+    EXPECT_FALSE(objLoader.StreamObj(test_path("mock/nao_existe.obj"), 0, count));
+}
+
+TEST(ObjLoaderTest, MissingFile) {
+    ObjLoader objLoader;
+    objLoader.use_cache = false;
+    objLoader.LoadObj(test_path("mock/nao_existe.obj"));
+    EXPECT_TRUE(objLoader.GetVertexSpan().empty());
+    EXPECT_TRUE(objLoader.GetPositionIndexSpan().empty());
 }
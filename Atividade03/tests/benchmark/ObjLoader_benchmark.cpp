@@ -0,0 +1,211 @@
+/**
+ * @file ObjLoader_benchmark.cpp
+ * @brief Mede o tempo de carregamento de `indoor_plant.obj` pelo `ObjLoader`.
+ * @author Martin Henrique Viana Adam
+ *
+ * Compara `ObjLoader::LoadObj` com a leitura anterior, baseada em `std::getline` e
+ * `std::istringstream`, mantida aqui apenas como referência, mede a leitura paralela de um
+ * arquivo maior com 1 a 16 threads e a leitura a partir do cache binário.
+ */
+
+#include "benchmark/benchmark.h"
+#include "../../includes/ObjLoader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+// Caminho de `indoor_plant.obj`, independente do diretório de execução.
+static std::string plant_path() {
+    std::string dir = __FILE__;
+    return dir.substr(0, dir.find_last_of("/\\") + 1) + "../../indoor_plant.obj";
+}
+
+static size_t file_size(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return static_cast<size_t>(file.tellg());
+}
+
+// Vetores preenchidos pela leitura anterior.
+struct StreamObj {
+    std::vector<Vertex> vertices;
+    std::vector<TextureCoord> textureCoords;
+    std::vector<Normal> normals;
+    std::vector<std::vector<Face>> faces;
+};
+
+// Leitura linha a linha com std::istringstream (implementação anterior de LoadObj).
+static void load_obj_istringstream(StreamObj& loader, const std::string& filename) {
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        iss >> token;
+
+        if (token == "v") {
+            Vertex vertex;
+            iss >> vertex.x >> vertex.y >> vertex.z;
+            loader.vertices.push_back(vertex);
+        } else if (token == "vt") {
+            TextureCoord texCoord;
+            iss >> texCoord.u >> texCoord.v;
+            loader.textureCoords.push_back(texCoord);
+        } else if (token == "vn") {
+            Normal normal;
+            iss >> normal.nx >> normal.ny >> normal.nz;
+            loader.normals.push_back(normal);
+        } else if (token == "f") {
+            std::vector<Face> faces_in_line;
+            for (int i = 0; i < 3; ++i) {
+                Face face;
+                if (line.find("//") != std::string::npos) {
+                    iss >> face.v1;
+                    iss.ignore();
+                    face.v2 = 0;
+                    iss.ignore();
+                    iss >> face.v3;
+                } else if (line.find("/") != std::string::npos) {
+                    iss >> face.v1;
+                    iss.ignore();
+                    iss >> face.v2;
+                    iss.ignore();
+                    iss >> face.v3;
+                } else {
+                    iss >> face.v1 >> face.v2 >> face.v3;
+                }
+                faces_in_line.push_back(face);
+            }
+            loader.faces.push_back(faces_in_line);
+        }
+    }
+}
+
+static void BM_LoadObj_istringstream(benchmark::State& state) {
+    const std::string path = plant_path();
+    for (auto _ : state) {
+        StreamObj loader;
+        load_obj_istringstream(loader, path);
+        benchmark::DoNotOptimize(loader.faces.data());
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj_istringstream)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadObj(benchmark::State& state) {
+    const std::string path = plant_path();
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.use_cache = false;
+        loader.LoadObj(path);
+        benchmark::DoNotOptimize(loader.GetPositionIndexSpan().data());
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj)->Unit(benchmark::kMillisecond);
+
+// Arquivo grande (a planta repetida 20 vezes, ~67 MB) para medir a escala com o número de threads.
+static const std::string& large_path() {
+    static const std::string path = [] {
+        std::string large = (std::filesystem::temp_directory_path() / "indoor_plant_x20.obj").string();
+        std::ifstream plant(plant_path(), std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(plant)), std::istreambuf_iterator<char>());
+        std::ofstream out(large, std::ios::binary);
+        for (int i = 0; i < 20; i++)
+            out << contents;
+        return large;
+    }();
+    return path;
+}
+
+static void BM_LoadObj_threads(benchmark::State& state) {
+    const std::string& path = large_path();
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.threads = static_cast<int>(state.range(0));
+        loader.use_cache = false;
+        loader.LoadObj(path);
+        benchmark::DoNotOptimize(loader.GetPositionIndexSpan().data());
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj_threads)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Leitura a partir do cache binário gravado ao lado do arquivo na primeira leitura.
+static void BM_LoadObj_cached(benchmark::State& state) {
+    const std::string path = plant_path();
+    ObjLoader first;
+    first.LoadObj(path);
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.LoadObj(path);
+        benchmark::DoNotOptimize(loader.GetPositionIndexSpan().data());
+        if (!loader.IsCached())
+            state.SkipWithError("cache não foi usado");
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj_cached)->Unit(benchmark::kMillisecond);
+
+// Leitura do cache seguida de uma passada por todos os índices de posição (páginas tocadas).
+static void BM_LoadObj_cached_touch(benchmark::State& state) {
+    const std::string path = plant_path();
+    ObjLoader first;
+    first.LoadObj(path);
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.LoadObj(path);
+        long sum = 0;
+        for (int index : loader.GetPositionIndexSpan())
+            sum += index;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj_cached_touch)->Unit(benchmark::kMillisecond);
+
+// Montagem dos triângulos (com posições e normais resolvidas) a partir dos dados carregados.
+static void BM_GetTriangleFaces(benchmark::State& state) {
+    ObjLoader loader;
+    loader.use_cache = false;
+    loader.LoadObj(plant_path());
+    for (auto _ : state) {
+        std::vector<triangle> triangles = loader.get_triangle_faces(0);
+        benchmark::DoNotOptimize(triangles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * loader.GetFaceCount());
+}
+BENCHMARK(BM_GetTriangleFaces)->Unit(benchmark::kMillisecond);
+
+// Leitura em fluxo do arquivo grande, com os triângulos entregues em lotes e descartados.
+static void BM_StreamObj(benchmark::State& state) {
+    const std::string& path = large_path();
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.stream_memory_budget = static_cast<size_t>(state.range(0)) << 20;
+        size_t triangles = 0;
+        if (!loader.StreamObj(path, 0, [&](Span<const triangle> batch) { triangles += batch.size(); }))
+            state.SkipWithError("orçamento de memória insuficiente");
+        benchmark::DoNotOptimize(triangles);
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_StreamObj)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// Leitura completa do arquivo grande seguida de get_triangle_faces, para comparar com BM_StreamObj.
+static void BM_LoadObj_triangles(benchmark::State& state) {
+    const std::string& path = large_path();
+    for (auto _ : state) {
+        ObjLoader loader;
+        loader.use_cache = false;
+        loader.LoadObj(path);
+        std::vector<triangle> triangles = loader.get_triangle_faces(0);
+        benchmark::DoNotOptimize(triangles.data());
+    }
+    state.SetBytesProcessed(state.iterations() * file_size(path));
+}
+BENCHMARK(BM_LoadObj_triangles)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -41,7 +41,7 @@ public:
      * @param t A distância ao longo do raio.
      * @return O ponto no espaço tridimensional correspondente à distância t ao longo do raio.
      */
-    point3 at(double t) const {
+    point3 at(real t) const {
         return orig + t * dir;
     }
 
@@ -8,7 +8,6 @@
 #include "../Atividade01/includes/ImageIO.cpp"
 #include "../Atividade02/includes/color.h"
 #include "../Atividade02/includes/vec3.h"
-#include "../Atividade02/includes/vec3.cpp"
 #include "../Atividade03/includes/ObjLoader.h"
 #include "../Atividade03/includes/ObjLoader.cpp"
 #include "includes/ray.h"
@@ -75,11 +74,11 @@ bool hit_triangle(const point3& vertex0, const point3& vertex1, const point3& ve
  *
  * @param r Raio a ser traçado.
  * @param type Tipo de objeto a ser verificado ("sphere", "triangle", "object").
- * @param vertices Ponteiro para o vetor de vértices (necessário para "object").
- * @param faces Ponteiro para o vetor de faces (necessário para "object").
+ * @param vertices Vértices do objeto (necessário para "object").
+ * @param indices Índices de posição das faces, três por face (necessário para "object").
  * @return Cor resultante do raio.
  */
-color ray_color(const ray &r, std::string type, std::vector<Vertex>* vertices = nullptr, std::vector<std::vector<Face> >* faces = nullptr) {
+color ray_color(const ray &r, std::string type, Span<const Vertex> vertices = Span<const Vertex>(), Span<const int> indices = Span<const int>()) {
     if (type == "sphere") {
         if (hit_sphere(point3(0, 0, -1), 0.5, r)) {
             return color(1, 0, 0);
@@ -93,14 +92,14 @@ color ray_color(const ray &r, std::string type, std::vector<Vertex>* vertices =
             return color(1, 0, 0);
         }
     } else if (type == "object") {
-         for (size_t i = 0; i < faces->size(); i++) {
-            int indiceV0 = (*faces)[i][0].v1;
-            int indiceV1 = (*faces)[i][1].v1;
-            int indiceV2 = (*faces)[i][2].v1;
+         for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            int indiceV0 = indices[i];
+            int indiceV1 = indices[i + 1];
+            int indiceV2 = indices[i + 2];
 
-            point3 v0((*vertices)[indiceV0].x, (*vertices)[indiceV0].y, (*vertices)[indiceV0].z);
-            point3 v1((*vertices)[indiceV1].x, (*vertices)[indiceV1].y, (*vertices)[indiceV1].z);
-            point3 v2((*vertices)[indiceV2].x, (*vertices)[indiceV2].y, (*vertices)[indiceV2].z);
+            point3 v0(vertices[indiceV0].x, vertices[indiceV0].y, vertices[indiceV0].z);
+            point3 v1(vertices[indiceV1].x, vertices[indiceV1].y, vertices[indiceV1].z);
+            point3 v2(vertices[indiceV2].x, vertices[indiceV2].y, vertices[indiceV2].z);
 
             if (hit_triangle(v0, v1, v2, r)) {
                 return color(1, 0, 0);
@@ -174,8 +173,8 @@ int main() {
     // Visualização do objeto
     ObjLoader objLoader;
     objLoader.LoadObj("/Users/renanoliveira/Desktop/ufscar/2023-02/computacao-grafica/atividades-projeto/Atividade04/hexagon.obj");
-    std::vector<Vertex> vertices = objLoader.vertices;
-    std::vector<std::vector<Face> > faces = objLoader.faces;
+    Span<const Vertex> vertices = objLoader.GetVertexSpan();
+    Span<const int> indices = objLoader.GetPositionIndexSpan();
 
     for (int j = 0; j < image_height; ++j) {
         for (int i = 0; i < image_width; ++i) {
@@ -183,7 +182,7 @@ int main() {
             auto ray_direction = pixel_center - origin;
             ray r(origin, ray_direction);
 
-            color pixel_color = ray_color(r, "object", &vertices, &faces);
+            color pixel_color = ray_color(r, "object", vertices, indices);
             
             image_data[(i + j * image_width) * 4] = static_cast<unsigned char>(255.999 * pixel_color.x());
             image_data[(i + j * image_width) * 4 + 1] = static_cast<unsigned char>(255.999 * pixel_color.y());
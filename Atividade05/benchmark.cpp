@@ -0,0 +1,693 @@
+/**
+ * @file benchmark.cpp
+ * @author Martin Henrique Viana Adam
+ * @brief Medições de desempenho do traçador de raios (raios por segundo).
+ */
+
+#include "./includes/utils.h"
+#include "./includes/camera.h"
+#include "./includes/color.h"
+#include "./includes/hittable_list.h"
+#include "./includes/material.h"
+#include "./includes/sampler.h"
+#include "./includes/sphere.h"
+#include "./includes/triangle.h"
+#include "./includes/bvh.h"
+#include "./includes/triangle_mesh.h"
+#include "../Atividade03/includes/ObjLoader.h"
+#include "../Atividade03/includes/ObjLoader.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Gera uma nuvem de triângulos pequenos distribuídos em um cubo de lado 20.
+ *
+ * @param count Quantidade de triângulos.
+ * @param mat Material atribuído aos triângulos.
+ * @return hittable_list Lista com os triângulos gerados.
+ */
+hittable_list random_triangles(int count, material_id mat) {
+    hittable_list list;
+    for (int i = 0; i < count; i++) {
+        point3 base = vec3::random(-10, 10);
+        point3 b = base + vec3::random(-0.3, 0.3);
+        point3 c = base + vec3::random(-0.3, 0.3);
+        vec3 n = unit_vector(cross(b - base, c - base));
+        list.add(make_shared<triangle>(vertex(base, n), vertex(b, n), vertex(c, n), mat));
+    }
+    return list;
+}
+
+/**
+ * @brief Converte uma lista de triângulos em uma malha indexada (sem vértices compartilhados).
+ *
+ * @param list Lista com objetos `triangle`.
+ * @return shared_ptr<mesh_data> Buffers da malha.
+ */
+shared_ptr<mesh_data> mesh_from_triangles(const hittable_list& list) {
+    auto mesh = make_shared<mesh_data>();
+    for (const auto& object : list.objects) {
+        const triangle& tri = *std::static_pointer_cast<triangle>(object);
+        for (const vertex* v : {&tri.A, &tri.B, &tri.C}) {
+            mesh->position_indices.push_back(static_cast<uint32_t>(mesh->positions.size() / 3));
+            for (int k = 0; k < 3; k++)
+                mesh->positions.push_back(static_cast<float>(v->coord[k]));
+        }
+    }
+    return mesh;
+}
+
+/**
+ * @brief Mede quantos raios por segundo um objeto consegue interceptar.
+ *
+ * Os raios partem de pontos aleatórios fora do cubo em direção a pontos aleatórios dentro dele.
+ *
+ * @param world Objeto a ser testado.
+ * @param ray_count Quantidade de raios lançados.
+ * @return double Raios por segundo.
+ */
+double rays_per_second(const hittable& world, int ray_count) {
+    std::vector<ray> rays;
+    rays.reserve(ray_count);
+    for (int i = 0; i < ray_count; i++) {
+        point3 origin = 30.0 * unit_vector(vec3::random(-1, 1));
+        point3 target = vec3::random(-10, 10);
+        rays.push_back(ray(origin, target - origin));
+    }
+
+    int hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const ray& r : rays) {
+        hit_record rec;
+        if (world.hit(r, interval(0.001, infinity), rec))
+            hits++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Evita que o compilador descarte o laço de interseção.
+    if (hits < 0)
+        std::printf("%d\n", hits);
+
+    return ray_count / elapsed.count();
+}
+
+/**
+ * @brief Compara a busca linear da hittable_list com a BVH para cenas de tamanhos crescentes.
+ */
+void benchmark_bvh() {
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+
+    std::printf("%-12s %16s %16s %10s\n", "triangulos", "lista (raios/s)", "bvh (raios/s)", "ganho");
+    for (int count : {100, 1000, 10000, 100000}) {
+        hittable_list list = random_triangles(count, mat);
+        bvh_node bvh(list);
+
+        // A busca linear é O(n) por raio, então reduzimos a quantidade de raios para cenas grandes.
+        int list_rays = std::max(200, 2000000 / count);
+        double list_rps = rays_per_second(list, list_rays);
+        double bvh_rps = rays_per_second(bvh, 50000);
+
+        std::printf("%-12d %16.0f %16.0f %9.1fx\n", count, list_rps, bvh_rps, bvh_rps / list_rps);
+    }
+}
+
+/**
+ * @brief Mede o custo de cada teste raio-triângulo isolado, sem estrutura de aceleração.
+ *
+ * Cada raio é testado contra todos os triângulos, uma vez com `triangle::intersect` e outra com o
+ * kernel em lote de `triangle_block`.
+ */
+void benchmark_intersection_tests() {
+    const int triangle_count = 1024;
+    const int ray_count = 4000;
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+
+    hittable_list list = random_triangles(triangle_count, mat);
+    std::vector<triangle_block> blocks(triangle_count / triangle_block::width);
+    for (int i = 0; i < triangle_count; i++) {
+        const triangle& tri = *std::static_pointer_cast<triangle>(list.objects[i]);
+        blocks[i / triangle_block::width].set(i % triangle_block::width, tri.A.coord, tri.B.coord, tri.C.coord, i);
+    }
+
+    std::vector<ray> rays;
+    for (int i = 0; i < ray_count; i++) {
+        point3 origin = 30.0 * unit_vector(vec3::random(-1, 1));
+        rays.push_back(ray(origin, vec3::random(-10, 10) - origin));
+    }
+
+    int scalar_hits = 0, block_hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const ray& r : rays) {
+        surface_hit h;
+        for (const auto& object : list.objects)
+            scalar_hits += object->intersect(r, interval(0.001, infinity), h);
+    }
+    std::chrono::duration<double> scalar_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (const ray& r : rays) {
+        const ray_f rf(r);
+        for (const auto& block : blocks) {
+            block_hit hit;
+            float tmax = std::numeric_limits<float>::infinity();
+            block_hits += intersect_block(block, rf, 0.001f, tmax, hit);
+        }
+    }
+    std::chrono::duration<double> block_time = std::chrono::steady_clock::now() - start;
+
+    double tests = static_cast<double>(triangle_count) * ray_count;
+    std::printf("triangle::intersect %8.1f M testes/s (%d acertos)\n", tests / scalar_time.count() / 1e6, scalar_hits);
+    std::printf("triangle_block      %8.1f M testes/s (%d blocos com acerto)\n", tests / block_time.count() / 1e6, block_hits);
+    std::printf("ganho por teste  %8.1fx\n", scalar_time.count() / block_time.count());
+}
+
+/**
+ * @brief Compara a BVH de objetos `triangle` com o `triangle_mesh` (blocos SoA em float).
+ *
+ * As duas estruturas usam a mesma BVH, então a diferença vem do custo por interseção e da
+ * quantidade de chamadas virtuais.
+ */
+void benchmark_triangle_kernel() {
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+
+    std::printf("%-12s %16s %16s %10s\n", "triangulos", "triangle (r/s)", "malha (r/s)", "ganho");
+    for (int count : {1000, 10000, 100000}) {
+        hittable_list list = random_triangles(count, mat);
+        bvh_node bvh(list.objects, triangle_block::width);
+        triangle_mesh mesh(mesh_from_triangles(list), mat);
+
+        double scalar_rps = rays_per_second(bvh, 50000);
+        double mesh_rps = rays_per_second(mesh, 50000);
+
+        std::printf("%-12d %16.0f %16.0f %9.1fx\n", count, scalar_rps, mesh_rps, mesh_rps / scalar_rps);
+    }
+}
+
+/**
+ * @brief Compara a memória de uma malha em grade como objetos `triangle` e como `triangle_mesh`.
+ *
+ * Para os objetos `triangle` é contada a cópia devolvida por `ObjLoader::get_triangle_faces`, a
+ * cópia em cada `make_shared<triangle>` (com o bloco de controle), os ponteiros na lista e na BVH
+ * e os nós da BVH.
+ */
+void benchmark_mesh_memory() {
+    const int n = 300;
+    auto mesh = make_shared<mesh_data>();
+    for (int j = 0; j <= n; j++) {
+        for (int i = 0; i <= n; i++) {
+            mesh->positions.push_back(static_cast<float>(i));
+            mesh->positions.push_back(0.0f);
+            mesh->positions.push_back(static_cast<float>(j));
+            mesh->normals.push_back(0.0f);
+            mesh->normals.push_back(1.0f);
+            mesh->normals.push_back(0.0f);
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            uint32_t a = j * (n + 1) + i, b = a + 1, c = a + (n + 1), d = c + 1;
+            for (uint32_t index : {a, b, c, b, d, c}) {
+                mesh->position_indices.push_back(index);
+                mesh->normal_indices.push_back(index);
+            }
+        }
+    }
+
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+    triangle_mesh indexed(mesh, mat);
+
+    size_t count = mesh->triangle_count();
+    size_t per_triangle = 2 * sizeof(triangle) + 2 * sizeof(long) + 2 * sizeof(shared_ptr<hittable>);
+    size_t objects_bytes = count * per_triangle + (2 * count / 4) * sizeof(bvh_tree_node);
+
+    std::printf("triangulos: %zu\n", count);
+    std::printf("objetos triangle  ~%8.1f MB\n", objects_bytes / 1e6);
+    std::printf("triangle_mesh      %8.1f MB\n", indexed.memory_usage() / 1e6);
+    std::printf("reducao            %8.1fx\n", static_cast<double>(objects_bytes) / indexed.memory_usage());
+}
+
+/**
+ * @brief Monta a cena do programa principal (`main.cpp`).
+ *
+ * @param world Lista que recebe os objetos da cena.
+ * @param materials Tabela que recebe os materiais da cena.
+ */
+void build_main_scene(hittable_list& world, material_table& materials) {
+    world.add(make_shared<sphere>(point3(0,-1000,0), 1000, materials.add(lambertian(color(0.5, 0.5, 0.5)))));
+
+    ObjLoader obj;
+    obj.LoadObj("cube.obj");
+    auto cube_mesh = obj.get_mesh_data();
+    cube_mesh->transform(mat4::translation(vec3(0, 1, 0)));
+    world.add(make_shared<triangle_mesh>(cube_mesh, materials.add(lambertian(color(0.9, 0.1, 0.3)))));
+
+    world.add(make_shared<sphere>(point3(0, 1, 0), 1.0, materials.add(lambertian(color(0.4, 0.2, 0.1)))));
+    world.add(make_shared<sphere>(point3(-4, 1, 0), 1.0, materials.add(lambertian(color(1, 0.7, 0.5)))));
+}
+
+/**
+ * @brief Calcula a raiz do erro quadrático médio entre as cores médias de dois buffers HDR.
+ */
+double hdr_rmse(const std::vector<float>& image, const std::vector<float>& reference) {
+    double sum = 0;
+    for (size_t i = 0; i < image.size(); i += 4) {
+        for (int c = 0; c < 3; c++) {
+            double d = image[i + c] / image[i + 3] - reference[i + c] / reference[i + 3];
+            sum += d * d;
+        }
+    }
+    return sqrt(sum / (image.size() / 4 * 3));
+}
+
+/**
+ * @brief Compara o erro (RMSE) dos amostradores em função do número de amostras por pixel.
+ *
+ * A referência é a cena de `main.cpp` renderizada com 4096 amostras de uma sequência de Sobol
+ * com semente diferente, independente das sequências avaliadas.
+ */
+void benchmark_samplers() {
+    hittable_list world;
+    material_table materials;
+    build_main_scene(world, materials);
+    bvh_node scene(world);
+
+    auto setup = [](camera& cam, int samples, shared_ptr<sampler> s) {
+        configure_camera(cam, 16.0 / 9.0, 96, 30, point3(0, 5, 20), point3(0, 0, 0), vec3(0, 1, 0), 0.6, 10.0);
+        cam.samples_per_pixel = samples;
+        cam.pixel_sampler = s;
+        cam.print_stats = false;
+    };
+
+    camera reference;
+    setup(reference, 4096, make_shared<sobol_sampler>(0x2545f491u));
+    reference.render(scene, materials);
+
+    std::printf("%-8s %14s %14s %14s %14s\n", "amostras", "independente", "estratificado", "sobol", "ruido azul");
+    for (int samples : {1, 4, 16, 64, 256}) {
+        shared_ptr<sampler> samplers[] = {
+            make_shared<independent_sampler>(),
+            make_shared<stratified_sampler>(samples),
+            make_shared<sobol_sampler>(),
+            make_shared<blue_noise_sampler>()
+        };
+
+        std::printf("%-8d", samples);
+        for (const auto& s : samplers) {
+            camera cam;
+            setup(cam, samples, s);
+            cam.render(scene, materials);
+            std::printf(" %14.5f", hdr_rmse(cam.hdr_buffer(), reference.hdr_buffer()));
+        }
+        std::printf("\n");
+    }
+}
+
+/**
+ * @brief Gera os raios primários (um por pixel, sem jitter) de uma câmera pinhole, em ordem de linhas.
+ */
+std::vector<ray> primary_rays(int width, int height, point3 lookfrom, point3 lookat, double vfov) {
+    vec3 w = unit_vector(lookfrom - lookat);
+    vec3 u = unit_vector(cross(vec3(0, 1, 0), w));
+    vec3 v = cross(w, u);
+    double viewport_height = 2 * tan(degrees_to_radians(vfov) / 2);
+    double viewport_width = viewport_height * width / height;
+
+    std::vector<ray> rays;
+    rays.reserve(static_cast<size_t>(width) * height);
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            double s = (i + 0.5) / width - 0.5, t = 0.5 - (j + 0.5) / height;
+            rays.push_back(ray(lookfrom, s * viewport_width * u + t * viewport_height * v - w));
+        }
+    }
+    return rays;
+}
+
+/**
+ * @brief Mede a visibilidade primária (raios por segundo) com raios isolados e com pacotes de `N`.
+ *
+ * Com `N = 1`, cada raio é testado com `intersect`; caso contrário, `N` raios vizinhos de uma linha
+ * formam um pacote testado com `intersect_packet`.
+ */
+template <int N>
+double primary_rays_per_second(const hittable& world, const std::vector<ray>& rays, int& hits) {
+    hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < 4; repeat++) {
+        for (size_t first = 0; first < rays.size(); first += (N > 1 ? N : 1)) {
+            if constexpr (N == 1) {
+                surface_hit h;
+                if (world.intersect(rays[first], interval(0.001, infinity), h))
+                    hits++;
+            } else {
+                ray_packet<N> packet;
+                for (int lane = 0; lane < N; lane++)
+                    packet.set(lane, rays[first + lane]);
+                world.intersect_packet(packet);
+                for (int lane = 0; lane < N; lane++)
+                    hits += packet.object[lane] != nullptr;
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    hits /= 4;
+    return 4 * rays.size() / elapsed.count();
+}
+
+/**
+ * @brief Compara raios primários isolados com pacotes de 4 e 8 raios na cena de `main.cpp` e
+ * em uma nuvem de triângulos.
+ */
+void benchmark_packets() {
+    hittable_list main_world;
+    material_table materials;
+    build_main_scene(main_world, materials);
+    bvh_node main_scene(main_world);
+
+    hittable_list cloud = random_triangles(20000, materials.add(lambertian(color(0.5, 0.5, 0.5))));
+    bvh_node cloud_scene(cloud);
+
+    struct scene_case { const char* name; const hittable* world; std::vector<ray> rays; };
+    scene_case cases[] = {
+        {"cena principal", &main_scene, primary_rays(640, 360, point3(0, 5, 20), point3(0, 0, 0), 30)},
+        {"triangulos", &cloud_scene, primary_rays(640, 360, point3(0, 0, 30), point3(0, 0, 0), 45)},
+    };
+
+    std::printf("%-16s %14s %14s %14s %8s %8s\n", "cena", "escalar", "pacote 4", "pacote 8", "ganho 4", "ganho 8");
+    for (const auto& c : cases) {
+        int hits1, hits4, hits8;
+        double scalar = primary_rays_per_second<1>(*c.world, c.rays, hits1);
+        double packet4 = primary_rays_per_second<4>(*c.world, c.rays, hits4);
+        double packet8 = primary_rays_per_second<8>(*c.world, c.rays, hits8);
+        if (hits1 != hits4 || hits1 != hits8)
+            std::printf("aviso: interseções diferentes (%d, %d, %d)\n", hits1, hits4, hits8);
+        std::printf("%-16s %14.0f %14.0f %14.0f %7.2fx %7.2fx\n", c.name, scalar, packet4, packet8,
+                    packet4 / scalar, packet8 / scalar);
+    }
+}
+
+/**
+ * @brief Compara a consulta de oclusão (`occluded`) com a busca da interseção mais próxima em
+ * raios de sombra.
+ *
+ * Os raios de sombra partem dos pontos atingidos pelos raios primários em direção a uma luz
+ * pontual e só precisam saber se o segmento até a luz está livre.
+ */
+void benchmark_occlusion() {
+    hittable_list main_world;
+    material_table materials;
+    build_main_scene(main_world, materials);
+    bvh_node main_scene(main_world);
+
+    hittable_list cloud = random_triangles(20000, materials.add(lambertian(color(0.5, 0.5, 0.5))));
+    bvh_node cloud_scene(cloud);
+
+    struct scene_case { const char* name; const hittable* world; std::vector<ray> rays; point3 light; };
+    scene_case cases[] = {
+        {"cena principal", &main_scene, primary_rays(320, 180, point3(0, 5, 20), point3(0, 0, 0), 30), point3(-6, 4, 3)},
+        {"triangulos", &cloud_scene, primary_rays(320, 180, point3(0, 0, 30), point3(0, 0, 0), 45), point3(0, 20, 0)},
+    };
+
+    std::printf("%-16s %8s %14s %14s %8s %12s\n", "cena", "bloqueio", "mais proxima", "oclusao", "ganho", "nos/consulta");
+    for (const auto& c : cases) {
+        std::vector<ray> shadow_rays;
+        for (const ray& r : c.rays) {
+            hit_record rec;
+            if (c.world->hit(r, interval(0.001, infinity), rec))
+                shadow_rays.push_back(ray(rec.p, c.light - rec.p));
+        }
+        const interval segment(0.001, 1 - 1e-4);
+
+        const int repeats = 8;
+        int closest_blocked = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < repeats; repeat++) {
+            for (const ray& r : shadow_rays) {
+                surface_hit h;
+                if (c.world->intersect(r, segment, h))
+                    closest_blocked++;
+            }
+        }
+        std::chrono::duration<double> closest_time = std::chrono::steady_clock::now() - start;
+
+        occlusion_counters().reset();
+        start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < repeats; repeat++) {
+            for (const ray& r : shadow_rays)
+                c.world->occluded(r, segment);
+        }
+        std::chrono::duration<double> occlusion_time = std::chrono::steady_clock::now() - start;
+
+        const occlusion_stats& counters = occlusion_counters();
+        if (static_cast<uint64_t>(closest_blocked) != counters.occluded)
+            std::printf("aviso: bloqueios diferentes (%d, %llu)\n", closest_blocked,
+                        static_cast<unsigned long long>(counters.occluded));
+        double closest_rps = repeats * shadow_rays.size() / closest_time.count();
+        double occlusion_rps = repeats * shadow_rays.size() / occlusion_time.count();
+        std::printf("%-16s %7.1f%% %14.0f %14.0f %7.2fx %12.1f\n", c.name,
+                    100.0 * counters.occluded / counters.queries, closest_rps, occlusion_rps,
+                    occlusion_rps / closest_rps, static_cast<double>(counters.nodes) / counters.queries);
+    }
+}
+
+/**
+ * @brief Compara os kernels compilados para cada nível SIMD suportado pela CPU.
+ *
+ * Mede o kernel de blocos de triângulos (malha com 100000 triângulos), os pacotes de 8 raios
+ * primários na cena de `main.cpp` e a conversão do buffer HDR para 8 bits.
+ */
+void benchmark_simd_levels() {
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+    triangle_mesh mesh(mesh_from_triangles(random_triangles(100000, mat)), mat);
+
+    hittable_list main_world;
+    build_main_scene(main_world, materials);
+    bvh_node main_scene(main_world);
+    std::vector<ray> rays = primary_rays(640, 360, point3(0, 5, 20), point3(0, 0, 0), 30);
+
+    std::vector<float> hdr(1920 * 1080 * 4);
+    for (size_t i = 0; i < hdr.size(); i += 4) {
+        for (int c = 0; c < 3; c++)
+            hdr[i + c] = static_cast<float>(random_double(0, 64));
+        hdr[i + 3] = 64;
+    }
+    std::vector<unsigned char> rgba(hdr.size());
+
+    const simd_level initial = active_simd_level();
+    std::printf("%-8s %14s %14s %16s\n", "nivel", "malha (r/s)", "pacote 8 (r/s)", "resolve (Mpx/s)");
+    for (simd_level level : {simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512}) {
+        if (force_simd_level(level) != level)
+            continue;
+
+        int hits;
+        double mesh_rps = rays_per_second(mesh, 50000);
+        double packet_rps = primary_rays_per_second<8>(main_scene, rays, hits);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int repeat = 0; repeat < 10; repeat++)
+            resolve_image(hdr, rgba);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::printf("%-8s %14.0f %14.0f %16.1f\n", simd_level_name(level), mesh_rps, packet_rps,
+                    10 * hdr.size() / 4 / elapsed.count() / 1e6);
+    }
+    force_simd_level(initial);
+}
+
+/**
+ * @brief Mede os laços de interseção de `sphere` e `triangle`, dominados pelas operações de `vec3`.
+ *
+ * Cada raio é testado contra todos os objetos com `hit` (interseção e registro completo), sem
+ * estrutura de aceleração, então o tempo medido vem de `dot`, `cross`, `operator-` e
+ * `unit_vector`, que só são expandidos no laço quando definidos no cabeçalho.
+ */
+void benchmark_vector_math() {
+    const int object_count = 1024;
+    const int ray_count = 2000;
+    material_table materials;
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+
+    std::vector<sphere> spheres;
+    for (int i = 0; i < object_count; i++)
+        spheres.emplace_back(vec3::random(-10, 10), random_double(0.1, 0.5), mat);
+    hittable_list list = random_triangles(object_count, mat);
+    std::vector<triangle> triangles;
+    for (const auto& object : list.objects)
+        triangles.push_back(*std::static_pointer_cast<triangle>(object));
+
+    std::vector<ray> rays;
+    for (int i = 0; i < ray_count; i++) {
+        point3 origin = 30.0 * unit_vector(vec3::random(-1, 1));
+        rays.push_back(ray(origin, vec3::random(-10, 10) - origin));
+    }
+
+    int sphere_hits = 0, triangle_hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const ray& r : rays) {
+        for (const sphere& s : spheres) {
+            hit_record rec;
+            sphere_hits += s.hit(r, interval(0.001, infinity), rec);
+        }
+    }
+    std::chrono::duration<double> sphere_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (const ray& r : rays) {
+        for (const triangle& tri : triangles) {
+            hit_record rec;
+            triangle_hits += tri.hit(r, interval(0.001, infinity), rec);
+        }
+    }
+    std::chrono::duration<double> triangle_time = std::chrono::steady_clock::now() - start;
+
+    double tests = static_cast<double>(object_count) * ray_count;
+    std::printf("sphere::hit   %8.1f M testes/s (%d acertos)\n", tests / sphere_time.count() / 1e6, sphere_hits);
+    std::printf("triangle::hit %8.1f M testes/s (%d acertos)\n", tests / triangle_time.count() / 1e6, triangle_hits);
+}
+
+/**
+ * @brief Mostra o tamanho das estruturas e o desempenho com a precisão escolhida na compilação.
+ *
+ * Compile com e sem `-DRT_USE_FLOAT` para comparar. São medidos a cena de `main.cpp` e uma grade
+ * ondulada de 180 mil triângulos escrita em um arquivo OBJ e carregada como objetos `triangle`.
+ */
+void benchmark_precision() {
+    std::printf("real = %s\n", sizeof(real) == sizeof(float) ? "float" : "double");
+    std::printf("%-14s %4zu bytes\n", "vec3", sizeof(vec3));
+    std::printf("%-14s %4zu bytes\n", "ray", sizeof(ray));
+    std::printf("%-14s %4zu bytes\n", "hit_record", sizeof(hit_record));
+    std::printf("%-14s %4zu bytes\n", "surface_hit", sizeof(surface_hit));
+    std::printf("%-14s %4zu bytes\n", "sphere", sizeof(sphere));
+    std::printf("%-14s %4zu bytes\n", "triangle", sizeof(triangle));
+    std::printf("%-14s %4zu bytes\n", "fila wavefront", 9 * sizeof(real) + sizeof(uint32_t));
+
+    hittable_list world;
+    material_table materials;
+    build_main_scene(world, materials);
+    bvh_node scene(world);
+
+    camera cam;
+    configure_camera(cam, 16.0 / 9.0, 200, 30, point3(0, 5, 20), point3(0, 0, 0), vec3(0, 1, 0), 0.6, 10.0);
+    cam.samples_per_pixel = 16;
+    cam.threads = 1;
+    cam.print_stats = false;
+    auto start = std::chrono::steady_clock::now();
+    cam.render(scene, materials);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("cena de main.cpp: %8.2f Mraios/s (1 thread)\n", cam.last_render_stats().rays / elapsed.count() / 1e6);
+
+    const int n = 300;
+    const char* path = "benchmark_grade.obj";
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr)
+        return;
+    for (int j = 0; j <= n; j++)
+        for (int i = 0; i <= n; i++)
+            std::fprintf(file, "v %.6f %.6f %.6f\n", 20.0 * i / n - 10, std::sin(i * 0.1) * std::cos(j * 0.1), 20.0 * j / n - 10);
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int a = j * (n + 1) + i + 1, b = a + 1, c = a + (n + 1), d = c + 1;
+            std::fprintf(file, "f %d %d %d\nf %d %d %d\n", a, b, c, b, d, c);
+        }
+    }
+    std::fclose(file);
+
+    ObjLoader obj;
+    obj.use_cache = false;
+    obj.LoadObj(path);
+    std::remove(path);
+    material_id mat = materials.add(lambertian(color(0.5, 0.5, 0.5)));
+    hittable_list list;
+    for (const triangle& tri : obj.get_triangle_faces(mat))
+        list.add(make_shared<triangle>(tri));
+    bvh_node bvh(list.objects, triangle_block::width);
+
+    size_t count = list.objects.size();
+    size_t per_triangle = sizeof(triangle) + 2 * sizeof(long) + 2 * sizeof(shared_ptr<hittable>);
+    size_t objects_bytes = count * per_triangle + (2 * count / 4) * sizeof(bvh_tree_node);
+    std::printf("OBJ (%zu triangulos): ~%6.1f MB, %10.0f raios/s\n", count, objects_bytes / 1e6, rays_per_second(bvh, 50000));
+}
+
+/**
+ * @brief Mede a transformação de uma malha de 1 milhão de vértices.
+ *
+ * Compara um laço escalar com `transform_point` em `double`, as funções em lote de `transform.h`
+ * e uma cópia com `memcpy` do mesmo buffer, que dá o limite imposto pela largura de banda.
+ */
+void benchmark_mesh_transform() {
+    const size_t count = 1 << 20;
+    const int repeats = 10;
+    std::vector<float> in(3 * count), out(3 * count);
+    for (float& value : in)
+        value = static_cast<float>(random_double(-10, 10));
+    mat4 m = mat4::translation(vec3(1, 2, 3)) * mat4::rotation(vec3(0, 1, 0), 0.5) * mat4::scaling(vec3(2, 2, 2));
+    mat3 n = normal_matrix(m);
+    double gb = repeats * 2.0 * in.size() * sizeof(float) / 1e9;
+
+    auto measure = [&](const char* name, auto&& body) {
+        body();
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-22s %8.1f M vértices/s %6.1f GB/s\n", name,
+                    repeats * count / elapsed.count() / 1e6, gb / elapsed.count());
+    };
+
+    measure("transform_point", [&] {
+        for (size_t i = 0; i < count; i++) {
+            point3 p = transform_point(m, point3(in[3*i], in[3*i + 1], in[3*i + 2]));
+            out[3*i] = static_cast<float>(p.x());
+            out[3*i + 1] = static_cast<float>(p.y());
+            out[3*i + 2] = static_cast<float>(p.z());
+        }
+    });
+    measure("transform_points", [&] { transform_points(m, in.data(), out.data(), count); });
+    measure("transform_normals", [&] { transform_normals(n, in.data(), out.data(), count); });
+    measure("memcpy", [&] { std::memcpy(out.data(), in.data(), in.size() * sizeof(float)); });
+}
+
+int main() {
+    std::printf("Nível SIMD: %s (RT_SIMD força outro nível)\n\n", simd_level_name(active_simd_level()));
+
+    std::printf("== BVH (SAH) x hittable_list ==\n");
+    benchmark_bvh();
+
+    std::printf("\n== Laços de interseção: esfera e triângulo (vec3 no cabeçalho) ==\n");
+    benchmark_vector_math();
+
+    std::printf("\n== Transformação de malha: 1 milhão de vértices ==\n");
+    benchmark_mesh_transform();
+
+    std::printf("\n== Teste raio-triângulo: escalar x bloco SoA ==\n");
+    benchmark_intersection_tests();
+
+    std::printf("\n== Kernel de triângulos: triangle x triangle_mesh ==\n");
+    benchmark_triangle_kernel();
+
+    std::printf("\n== Memória: objetos triangle x triangle_mesh ==\n");
+    benchmark_mesh_memory();
+
+    std::printf("\n== Visibilidade primária: raios isolados x pacotes SIMD ==\n");
+    benchmark_packets();
+
+    std::printf("\n== Raios de sombra: interseção mais próxima x oclusão ==\n");
+    benchmark_occlusion();
+
+    std::printf("\n== Kernels por nível SIMD ==\n");
+    benchmark_simd_levels();
+
+    std::printf("\n== Precisão (compile com -DRT_USE_FLOAT para float) ==\n");
+    benchmark_precision();
+
+    std::printf("\n== Amostradores: RMSE x amostras por pixel (cena de main.cpp) ==\n");
+    benchmark_samplers();
+}
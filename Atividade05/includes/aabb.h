@@ -0,0 +1,154 @@
+/**
+ * @file aabb.h
+ * @brief Arquivo de implementação da classe Aabb
+ */
+
+#ifndef AABB_H
+#define AABB_H
+
+#include "./utils.h"
+
+/**
+ * @brief Caixa delimitadora alinhada aos eixos (axis-aligned bounding box).
+ *
+ * A classe `aabb` é formada por um intervalo em cada eixo e é utilizada pela BVH para
+ * descartar rapidamente grupos de objetos que não podem ser atingidos por um raio.
+ */
+class aabb {
+  public:
+    interval x, y, z; /**< Intervalos da caixa em cada eixo. */
+
+    /**
+     * @brief Construtor padrão que cria uma caixa vazia.
+     */
+    aabb() {}
+
+    /**
+     * @brief Construtor que cria uma caixa a partir de um intervalo por eixo.
+     *
+     * @param ix Intervalo no eixo x.
+     * @param iy Intervalo no eixo y.
+     * @param iz Intervalo no eixo z.
+     */
+    aabb(const interval& ix, const interval& iy, const interval& iz)
+      : x(ix), y(iy), z(iz) {}
+
+    /**
+     * @brief Construtor que cria a caixa a partir de dois pontos extremos.
+     *
+     * @param a Primeiro ponto extremo.
+     * @param b Segundo ponto extremo.
+     */
+    aabb(const point3& a, const point3& b) {
+        x = interval(fmin(a[0], b[0]), fmax(a[0], b[0]));
+        y = interval(fmin(a[1], b[1]), fmax(a[1], b[1]));
+        z = interval(fmin(a[2], b[2]), fmax(a[2], b[2]));
+    }
+
+    /**
+     * @brief Construtor que cria a menor caixa que contém outras duas caixas.
+     *
+     * @param box0 Primeira caixa.
+     * @param box1 Segunda caixa.
+     */
+    aabb(const aabb& box0, const aabb& box1)
+      : x(box0.x, box1.x), y(box0.y, box1.y), z(box0.z, box1.z) {}
+
+    /**
+     * @brief Retorna o intervalo da caixa em um eixo.
+     *
+     * @param n Índice do eixo (0 = x, 1 = y, 2 = z).
+     * @return const interval& Intervalo no eixo.
+     */
+    const interval& axis(int n) const {
+        if (n == 1) return y;
+        if (n == 2) return z;
+        return x;
+    }
+
+    /**
+     * @brief Garante uma espessura mínima em cada eixo.
+     *
+     * Triângulos alinhados aos eixos (como as faces do cubo) geram caixas sem espessura,
+     * o que torna o teste de slabs instável.
+     *
+     * @return aabb Caixa com espessura mínima.
+     */
+    aabb pad() const {
+        const double delta = 0.0001;
+        interval new_x = (x.size() >= delta) ? x : x.expand(delta);
+        interval new_y = (y.size() >= delta) ? y : y.expand(delta);
+        interval new_z = (z.size() >= delta) ? z : z.expand(delta);
+        return aabb(new_x, new_y, new_z);
+    }
+
+    /**
+     * @brief Retorna o centro da caixa.
+     *
+     * @return point3 Centro da caixa.
+     */
+    point3 centroid() const {
+        return point3(0.5 * (x.min + x.max), 0.5 * (y.min + y.max), 0.5 * (z.min + z.max));
+    }
+
+    /**
+     * @brief Calcula a área da superfície da caixa, usada pela heurística SAH.
+     *
+     * @return double Área da superfície (zero para caixas vazias).
+     */
+    double surface_area() const {
+        double dx = x.size(), dy = y.size(), dz = z.size();
+        if (dx < 0 || dy < 0 || dz < 0)
+            return 0;
+        return 2.0 * (dx*dy + dy*dz + dz*dx);
+    }
+
+    /**
+     * @brief Retorna o eixo de maior extensão da caixa.
+     *
+     * @return int Índice do eixo (0 = x, 1 = y, 2 = z).
+     */
+    int longest_axis() const {
+        if (x.size() > y.size())
+            return x.size() > z.size() ? 0 : 2;
+        return y.size() > z.size() ? 1 : 2;
+    }
+
+    /**
+     * @brief Verifica se um raio atravessa a caixa (teste de slabs).
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Intervalo válido do raio.
+     * @return true Se o raio atravessa a caixa dentro do intervalo.
+     * @return false Caso contrário.
+     */
+    bool hit(const ray& r, interval ray_t) const {
+        const point3 origin = r.origin();
+        const vec3 direction = r.direction();
+
+        for (int a = 0; a < 3; a++) {
+            auto invD = 1 / direction[a];
+            auto orig = origin[a];
+
+            auto t0 = (axis(a).min - orig) * invD;
+            auto t1 = (axis(a).max - orig) * invD;
+
+            if (invD < 0)
+                std::swap(t0, t1);
+
+            if (t0 > ray_t.min) ray_t.min = t0;
+            if (t1 < ray_t.max) ray_t.max = t1;
+
+            if (ray_t.max <= ray_t.min)
+                return false;
+        }
+        return true;
+    }
+
+    static const aabb empty, universe; /**< Caixas especiais: vazia e universo. */
+};
+
+inline const aabb aabb::empty    = aabb(interval::empty,    interval::empty,    interval::empty);    /**< Caixa vazia. */
+inline const aabb aabb::universe = aabb(interval::universe, interval::universe, interval::universe); /**< Caixa que cobre todo o espaço. */
+
+#endif
@@ -0,0 +1,523 @@
+/**
+ * @file bvh.h
+ * @brief Arquivo de implementação da hierarquia de volumes delimitadores (BVH)
+ */
+
+#ifndef BVH_H
+#define BVH_H
+
+#include "./utils.h"
+#include "./aabb.h"
+#include "./hittable.h"
+#include "./hittable_list.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Nó da BVH armazenado de forma linear (sem ponteiros).
+ *
+ * Nós internos guardam o índice do filho esquerdo em `first` (o direito é sempre `first + 1`);
+ * folhas guardam em `first` a posição da primeira primitiva e em `count` a quantidade.
+ */
+struct bvh_tree_node {
+    aabb bbox;      /**< Caixa delimitadora do nó. */
+    int  first = 0; /**< Filho esquerdo (nó interno) ou primeira primitiva (folha). */
+    int  count = 0; /**< Quantidade de primitivas; zero indica nó interno. */
+    int  axis  = 0; /**< Eixo utilizado na divisão, usado para ordenar a travessia. */
+};
+
+/**
+ * @brief Árvore BVH construída com a heurística de área de superfície (SAH).
+ *
+ * A árvore trabalha apenas com caixas delimitadoras e índices de primitivas, de forma que
+ * pode ser reutilizada tanto por listas de objetos quanto por malhas de triângulos.
+ */
+class bvh_tree {
+  public:
+    std::vector<bvh_tree_node> nodes; /**< Nós da árvore; a raiz é o nó 0. */
+    std::vector<int> indices;         /**< Índices das primitivas na ordem das folhas. */
+
+    /**
+     * @brief Constrói a árvore a partir das caixas delimitadoras das primitivas.
+     *
+     * @param boxes Caixa delimitadora de cada primitiva.
+     * @param max_leaf_size Quantidade máxima de primitivas por folha.
+     * @param block_size Quantidade de primitivas testadas de uma só vez em uma folha. A SAH
+     *                   passa a contar blocos em vez de primitivas, favorecendo folhas cheias.
+     */
+    void build(const std::vector<aabb>& boxes, int max_leaf_size = 4, int block_size = 1) {
+        nodes.clear();
+        leaf_block_size = block_size;
+        indices.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++)
+            indices[i] = static_cast<int>(i);
+
+        if (boxes.empty())
+            return;
+
+        centroids.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++)
+            centroids[i] = boxes[i].centroid();
+
+        nodes.reserve(2 * boxes.size());
+        nodes.push_back(bvh_tree_node());
+        build_range(boxes, 0, 0, static_cast<int>(boxes.size()), max_leaf_size, 0);
+
+        centroids.clear();
+        centroids.shrink_to_fit();
+    }
+
+    /**
+     * @brief Percorre a árvore procurando a interseção mais próxima.
+     *
+     * A função `hit_primitive(indice, ray_t)` deve testar a primitiva e, em caso de acerto,
+     * reduzir `ray_t.max` para o `t` encontrado e retornar verdadeiro.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Intervalo válido do raio.
+     * @param hit_primitive Função de teste de uma primitiva.
+     * @return true Se alguma primitiva foi atingida.
+     * @return false Caso contrário.
+     */
+    template <typename HitPrimitive>
+    bool traverse(const ray& r, interval ray_t, HitPrimitive&& hit_primitive) const {
+        return traverse_leaves(r, ray_t, [&](const bvh_tree_node& leaf, interval& t) {
+            bool hit_anything = false;
+            for (int i = leaf.first; i < leaf.first + leaf.count; i++) {
+                if (hit_primitive(indices[i], t))
+                    hit_anything = true;
+            }
+            return hit_anything;
+        });
+    }
+
+    /**
+     * @brief Percorre a árvore entregando folhas inteiras, em vez de primitivas individuais.
+     *
+     * Útil quando as primitivas de uma folha são testadas em conjunto (por exemplo, com SIMD).
+     * A função `hit_leaf(folha, ray_t)` segue o mesmo contrato de `traverse`.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Intervalo válido do raio.
+     * @param hit_leaf Função de teste de uma folha.
+     * @return true Se alguma folha foi atingida.
+     * @return false Caso contrário.
+     */
+    template <typename HitLeaf>
+    bool traverse_leaves(const ray& r, interval ray_t, HitLeaf&& hit_leaf) const {
+        if (nodes.empty())
+            return false;
+
+        const vec3 direction = r.direction();
+        bool hit_anything = false;
+
+        int stack[traversal_stack_size];
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const bvh_tree_node& node = nodes[stack[--stack_size]];
+            if (!node.bbox.hit(r, ray_t))
+                continue;
+
+            if (node.count > 0) {
+                if (hit_leaf(node, ray_t))
+                    hit_anything = true;
+                continue;
+            }
+
+            // Visita primeiro o filho mais próximo da origem do raio.
+            if (direction[node.axis] < 0) {
+                stack[stack_size++] = node.first;
+                stack[stack_size++] = node.first + 1;
+            } else {
+                stack[stack_size++] = node.first + 1;
+                stack[stack_size++] = node.first;
+            }
+        }
+
+        return hit_anything;
+    }
+
+    /**
+     * @brief Percorre a árvore até encontrar uma folha com alguma interseção (consulta de oclusão).
+     *
+     * A função `hit_leaf(folha, ray_t)` retorna verdadeiro se alguma primitiva da folha é
+     * atingida dentro de `ray_t`. Os nós visitados são somados em `occlusion_counters`.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio.
+     * @param hit_leaf Função de teste de uma folha.
+     * @return true Se alguma folha foi atingida.
+     * @return false Caso contrário.
+     */
+    template <typename HitLeaf>
+    bool traverse_any(const ray& r, interval ray_t, HitLeaf&& hit_leaf) const {
+        if (nodes.empty())
+            return false;
+
+        occlusion_stats& counters = occlusion_counters();
+        const vec3 direction = r.direction();
+
+        int stack[traversal_stack_size];
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+
+        while (stack_size > 0) {
+            const bvh_tree_node& node = nodes[stack[--stack_size]];
+            counters.nodes++;
+            if (!node.bbox.hit(r, ray_t))
+                continue;
+
+            if (node.count > 0) {
+                if (hit_leaf(node, ray_t))
+                    return true;
+                continue;
+            }
+
+            if (direction[node.axis] < 0) {
+                stack[stack_size++] = node.first;
+                stack[stack_size++] = node.first + 1;
+            } else {
+                stack[stack_size++] = node.first + 1;
+                stack[stack_size++] = node.first;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Percorre a árvore com um pacote de raios, entregando cada folha atingida.
+     *
+     * Um nó é visitado se ao menos um raio do pacote atravessa a sua caixa. A função
+     * `hit_leaf(folha)` testa o pacote inteiro e reduz o `tmax` das posições atingidas.
+     * A ordem dos filhos segue a direção do primeiro raio do pacote.
+     *
+     * @param packet Pacote de raios.
+     * @param hit_leaf Função de teste de uma folha.
+     */
+    template <int N, typename HitLeaf>
+    void traverse_packet(const ray_packet<N>& packet, HitLeaf&& hit_leaf) const {
+        if (nodes.empty())
+            return;
+
+        const double direction[3] = {packet.dx[0], packet.dy[0], packet.dz[0]};
+
+        // A travessia inteira é compilada para cada nível SIMD, com o teste das caixas expandido.
+        run_simd<N>([&](auto lanes) RT_ALWAYS_INLINE {
+            using V = typename decltype(lanes)::type;
+            int stack[traversal_stack_size];
+            int stack_size = 0;
+            stack[stack_size++] = 0;
+
+            while (stack_size > 0) {
+                const bvh_tree_node& node = nodes[stack[--stack_size]];
+                if (!packet.template hits_box<V>(node.bbox))
+                    continue;
+
+                if (node.count > 0) {
+                    hit_leaf(node);
+                    continue;
+                }
+
+                if (direction[node.axis] < 0) {
+                    stack[stack_size++] = node.first;
+                    stack[stack_size++] = node.first + 1;
+                } else {
+                    stack[stack_size++] = node.first + 1;
+                    stack[stack_size++] = node.first;
+                }
+            }
+        });
+    }
+
+  private:
+    std::vector<point3> centroids; /**< Centroides das primitivas, usados apenas na construção. */
+
+    static const int sah_bins = 16; /**< Quantidade de baldes avaliados por eixo. */
+
+    /**
+     * @brief Tamanho da pilha das travessias. Cada nível da árvore deixa no máximo um irmão
+     * pendente, então a pilha comporta árvores com até `traversal_stack_size - 1` níveis.
+     */
+    static const int traversal_stack_size = 64;
+
+    /**
+     * @brief Profundidade a partir da qual os nós são divididos pela mediana em vez da SAH.
+     *
+     * A SAH pode gerar árvores muito profundas (por exemplo, com caixas aninhadas que diminuem
+     * geometricamente). Abaixo deste nível cada divisão reduz as primitivas à metade, o que
+     * acrescenta no máximo 31 níveis e mantém a árvore dentro da pilha das travessias.
+     */
+    static const int max_sah_depth = traversal_stack_size - 32;
+    int leaf_block_size = 1;        /**< Primitivas testadas de uma só vez em uma folha. */
+
+    /**
+     * @brief Constrói recursivamente o nó `node_index`, de profundidade `depth`, com as primitivas em [begin, end).
+     */
+    void build_range(const std::vector<aabb>& boxes, int node_index, int begin, int end, int max_leaf_size, int depth) {
+        aabb bounds = aabb::empty;
+        aabb centroid_bounds = aabb::empty;
+        for (int i = begin; i < end; i++) {
+            bounds = aabb(bounds, boxes[indices[i]]);
+            centroid_bounds = aabb(centroid_bounds, aabb(centroids[indices[i]], centroids[indices[i]]));
+        }
+        nodes[node_index].bbox = bounds;
+
+        int count = end - begin;
+        if (count <= 1) {
+            make_leaf(node_index, begin, count);
+            return;
+        }
+
+        if (depth >= max_sah_depth) {
+            if (count <= max_leaf_size) {
+                make_leaf(node_index, begin, count);
+                return;
+            }
+            const int axis = centroid_bounds.longest_axis();
+            const int mid = begin + count / 2;
+            std::nth_element(indices.data() + begin, indices.data() + mid, indices.data() + end, [&](int a, int b) {
+                return centroids[a][axis] < centroids[b][axis];
+            });
+            split_node(boxes, node_index, begin, mid, end, axis, max_leaf_size, depth);
+            return;
+        }
+
+        // Avalia a SAH em baldes ao longo dos três eixos.
+        double best_cost = infinity;
+        int best_axis = -1;
+        int best_split = 0;
+
+        for (int axis = 0; axis < 3; axis++) {
+            const interval& extent = centroid_bounds.axis(axis);
+            if (extent.size() <= 0)
+                continue;
+
+            aabb bin_bounds[sah_bins];
+            int bin_count[sah_bins] = {0};
+            for (int i = begin; i < end; i++) {
+                int b = bin_of(centroids[indices[i]][axis], extent);
+                bin_count[b]++;
+                bin_bounds[b] = aabb(bin_bounds[b], boxes[indices[i]]);
+            }
+
+            double right_area[sah_bins];
+            int right_count[sah_bins];
+            aabb acc = aabb::empty;
+            int acc_count = 0;
+            for (int b = sah_bins - 1; b > 0; b--) {
+                acc = aabb(acc, bin_bounds[b]);
+                acc_count += bin_count[b];
+                right_area[b] = acc.surface_area();
+                right_count[b] = acc_count;
+            }
+
+            acc = aabb::empty;
+            acc_count = 0;
+            for (int split = 1; split < sah_bins; split++) {
+                acc = aabb(acc, bin_bounds[split - 1]);
+                acc_count += bin_count[split - 1];
+                if (acc_count == 0 || right_count[split] == 0)
+                    continue;
+
+                double cost = acc.surface_area() * blocks(acc_count) + right_area[split] * blocks(right_count[split]);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_split = split;
+                }
+            }
+        }
+
+        // Custo de travessia = 1, custo de interseção = 1, normalizados pela área do pai.
+        double parent_area = bounds.surface_area();
+        double leaf_cost = blocks(count);
+        double split_cost = parent_area > 0 ? 1.0 + best_cost / parent_area : infinity;
+
+        int mid;
+        if (best_axis < 0) {
+            // Todos os centroides coincidem: não há divisão útil pela SAH.
+            if (count <= max_leaf_size) {
+                make_leaf(node_index, begin, count);
+                return;
+            }
+            mid = begin + count / 2;
+            best_axis = bounds.longest_axis();
+        } else {
+            if (count <= max_leaf_size && leaf_cost <= split_cost) {
+                make_leaf(node_index, begin, count);
+                return;
+            }
+            const interval extent = centroid_bounds.axis(best_axis);
+            int* pivot = std::partition(indices.data() + begin, indices.data() + end, [&](int prim) {
+                return bin_of(centroids[prim][best_axis], extent) < best_split;
+            });
+            mid = static_cast<int>(pivot - indices.data());
+            if (mid == begin || mid == end)
+                mid = begin + count / 2;
+        }
+
+        split_node(boxes, node_index, begin, mid, end, best_axis, max_leaf_size, depth);
+    }
+
+    /**
+     * @brief Transforma o nó em um nó interno com as primitivas [begin, mid) à esquerda e [mid, end) à direita.
+     */
+    void split_node(const std::vector<aabb>& boxes, int node_index, int begin, int mid, int end, int axis,
+                    int max_leaf_size, int depth) {
+        int left = static_cast<int>(nodes.size());
+        nodes.push_back(bvh_tree_node());
+        nodes.push_back(bvh_tree_node());
+        nodes[node_index].first = left;
+        nodes[node_index].count = 0;
+        nodes[node_index].axis = axis;
+
+        build_range(boxes, left, begin, mid, max_leaf_size, depth + 1);
+        build_range(boxes, left + 1, mid, end, max_leaf_size, depth + 1);
+    }
+
+    /**
+     * @brief Transforma o nó em uma folha com as primitivas [first, first + count).
+     */
+    void make_leaf(int node_index, int first, int count) {
+        nodes[node_index].first = first;
+        nodes[node_index].count = count;
+    }
+
+    /**
+     * @brief Quantidade de testes de interseção necessários para `count` primitivas.
+     */
+    int blocks(int count) const {
+        return (count + leaf_block_size - 1) / leaf_block_size;
+    }
+
+    /**
+     * @brief Retorna o balde da SAH correspondente a uma coordenada do centroide.
+     */
+    static int bin_of(double value, const interval& extent) {
+        int b = static_cast<int>(sah_bins * (value - extent.min) / extent.size());
+        return b < 0 ? 0 : (b >= sah_bins ? sah_bins - 1 : b);
+    }
+};
+
+/**
+ * @brief Hierarquia de volumes delimitadores sobre uma lista de objetos.
+ *
+ * A classe `bvh_node` herda de `hittable` e pode substituir diretamente uma `hittable_list`
+ * em `camera::render`, trocando a busca linear por uma travessia em O(log n).
+ */
+class bvh_node : public hittable {
+  public:
+    /**
+     * @brief Constrói a BVH a partir dos objetos de uma lista.
+     *
+     * @param list Lista de objetos da cena.
+     */
+    bvh_node(const hittable_list& list) : bvh_node(list.objects) {}
+
+    /**
+     * @brief Constrói a BVH a partir de um vetor de objetos.
+     *
+     * @param src_objects Objetos a serem organizados na hierarquia.
+     * @param max_leaf_size Quantidade máxima de objetos por folha.
+     */
+    bvh_node(const std::vector<shared_ptr<hittable> >& src_objects, int max_leaf_size = 4) {
+        std::vector<aabb> boxes;
+        boxes.reserve(src_objects.size());
+        for (const auto& object : src_objects)
+            boxes.push_back(object->bounding_box());
+
+        tree.build(boxes, max_leaf_size);
+
+        // Reordena os objetos na ordem das folhas para melhorar a localidade na travessia.
+        objects.reserve(src_objects.size());
+        for (size_t i = 0; i < tree.indices.size(); i++) {
+            objects.push_back(src_objects[tree.indices[i]]);
+            tree.indices[i] = static_cast<int>(i);
+        }
+
+        bbox = tree.nodes.empty() ? aabb::empty : tree.nodes[0].bbox;
+    }
+
+    /**
+     * @brief Verifica a interseção mais próxima entre o raio e os objetos da hierarquia.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Dados auxiliares de intervalo do raio.
+     * @param h Estrutura para armazenamento da interseção mais próxima.
+     * @return true Se algum objeto intercepta o raio.
+     * @return false Se nenhum objeto intercepta o raio.
+     */
+    bool intersect(const ray& r, interval ray_t, surface_hit& h) const noexcept override {
+        return tree.traverse(r, ray_t, [&](int i, interval& t) {
+            if (!objects[i]->intersect(r, t, h))
+                return false;
+            t.max = h.t;
+            return true;
+        });
+    }
+
+    /**
+     * @brief Verifica se algum objeto da hierarquia bloqueia o segmento, parando no primeiro.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio.
+     * @return true Se algum objeto intercepta o segmento.
+     */
+    bool any_hit(const ray& r, interval ray_t) const override {
+        return tree.traverse_any(r, ray_t, [&](const bvh_tree_node& leaf, const interval& t) {
+            for (int i = leaf.first; i < leaf.first + leaf.count; i++) {
+                if (objects[tree.indices[i]]->any_hit(r, t))
+                    return true;
+            }
+            return false;
+        });
+    }
+
+    /**
+     * @brief Percorre a hierarquia com um pacote de raios.
+     *
+     * @param packet Pacote de raios.
+     */
+    void intersect_packet(ray_packet4& packet) const override { intersect_objects(packet); }
+    void intersect_packet(ray_packet8& packet) const override { intersect_objects(packet); }
+
+    /**
+     * @brief Repassa o sombreamento para o objeto atingido.
+     *
+     * @param r Raio incidente.
+     * @param h Interseção retornada por `intersect`.
+     * @param rec Registro de interseptação.
+     */
+    void shade(const ray& r, const surface_hit& h, hit_record& rec) const override {
+        h.object->shade(r, h, rec);
+    }
+
+    /**
+     * @brief Retorna a caixa delimitadora da raiz da hierarquia.
+     *
+     * @return aabb Caixa que envolve todos os objetos.
+     */
+    aabb bounding_box() const override { return bbox; }
+
+  private:
+    std::vector<shared_ptr<hittable> > objects; /**< Objetos na ordem das folhas. */
+    bvh_tree tree;                              /**< Estrutura da hierarquia. */
+    aabb bbox;                                  /**< Caixa delimitadora da raiz. */
+
+    /**
+     * @brief Repassa o pacote aos objetos das folhas atingidas.
+     */
+    template <int N>
+    void intersect_objects(ray_packet<N>& packet) const {
+        tree.traverse_packet(packet, [&](const bvh_tree_node& leaf) {
+            for (int i = leaf.first; i < leaf.first + leaf.count; i++)
+                objects[tree.indices[i]]->intersect_packet(packet);
+        });
+    }
+};
+
+#endif
@@ -10,25 +10,30 @@
 #include "./color.h"
 #include "./hittable.h"
 #include "./material.h"
+#include "./sampler.h"
+#include "./scheduler.h"
+#include "./wavefront.h"
 #include "../../Atividade01/includes/ImageIO.h"
 #include "../../Atividade01/includes/ImageIO.cpp"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <fstream>
-#include <random>
+#include <utility>
+#include <variant>
 
 /**
  * @brief Gera um ponto aleatório dentro de um disco unitário.
  * 
+ * @param u Amostras usadas (2 dimensões).
  * @return point3 Ponto aleatório no disco unitário.
  */
-point3 random_in_unit_disk() {
-    static std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    static std::mt19937 generator;  // Mersenne Twister
-
-    double theta = 2.0 * M_PI * distribution(generator);
-    double r = sqrt(distribution(generator));
+point3 random_in_unit_disk(sample_stream& u) {
+    double theta = 2.0 * M_PI * u.next();
+    double r = sqrt(u.next());
 
     double x = r * cos(theta);
     double y = r * sin(theta);
@@ -36,6 +41,40 @@ point3 random_in_unit_disk() {
     return point3(x, y, 0.0);  // Assumindo que o disco está no plano XY
 }
 
+/**
+ * @brief Estatísticas dos caminhos traçados em uma renderização.
+ */
+struct path_stats {
+    uint64_t rays = 0;             /**< Quantidade de raios traçados. */
+    uint64_t samples = 0;          /**< Quantidade de amostras de pixel. */
+    std::vector<uint64_t> lengths; /**< Quantidade de caminhos por número de segmentos (índice 0 não é usado). */
+
+    /**
+     * @brief Registra um caminho encerrado após `length` segmentos.
+     * 
+     * @param length Quantidade de raios do caminho.
+     */
+    void record(int length) {
+        if (static_cast<size_t>(length) >= lengths.size())
+            lengths.resize(length + 1, 0);
+        lengths[length]++;
+    }
+
+    /**
+     * @brief Soma as estatísticas de outra renderização parcial.
+     * 
+     * @param other Estatísticas a serem somadas.
+     */
+    void merge(const path_stats& other) {
+        rays += other.rays;
+        samples += other.samples;
+        if (other.lengths.size() > lengths.size())
+            lengths.resize(other.lengths.size(), 0);
+        for (size_t i = 0; i < other.lengths.size(); i++)
+            lengths[i] += other.lengths[i];
+    }
+};
+
 /**
  * @brief Classe que representa uma câmera na cena 3D.
  */
@@ -43,8 +82,20 @@ class camera {
   public:
     double aspect_ratio      = 1.0;  /**< Razão entre a largura e a altura da imagem. */
     int    image_width       = 100;  /**< Largura da imagem renderizada em pixels. */
-    int    samples_per_pixel = 10;   /**< Número de amostras aleatórias para cada pixel. */
+    int    samples_per_pixel = 10;   /**< Número de amostras aleatórias para cada pixel (máximo no modo adaptativo). */
+    int    threads           = 0;    /**< Número de threads de renderização (0 = todos os núcleos). */
     int    max_depth         = 10;   /**< Número máximo de reflexões dos raios na cena. */
+    int    roulette_depth    = 3;    /**< Rebatimento a partir do qual a roleta russa encerra caminhos (0 desativa). */
+
+    bool   adaptive        = false;  /**< Encerra a amostragem de cada pixel quando o ruído estimado fica abaixo do limite. */
+    int    min_samples     = 16;     /**< Número mínimo de amostras por pixel no modo adaptativo. */
+    double noise_threshold = 0.005;  /**< Erro padrão máximo, após a correção gamma, para encerrar a amostragem. */
+
+    bool   wavefront = false;        /**< Renderiza cada bloco em estágios sobre filas de raios (ignorado no modo adaptativo). */
+    int    packet_size = 0;          /**< Raios primários traçados juntos em um pacote SIMD: 4 ou 8 (0 = um por vez; ignorado no modo adaptativo). */
+
+    /** Amostrador usado no pixel, na lente e nos rebatimentos (independente por padrão). */
+    shared_ptr<sampler> pixel_sampler = make_shared<independent_sampler>();
 
     double vfov     = 90;              /**< Ângulo de visão vertical (campo de visão). */
     point3 lookfrom = point3(0,0,-1);  /**< Ponto de onde a câmera está olhando. */
@@ -54,36 +105,118 @@ class camera {
     double defocus_angle = 0;  /**< Ângulo de variação dos raios através de cada pixel. */
     double focus_dist = 10;    /**< Distância do ponto de vista da câmera ao plano de foco perfeito. */
 
+    bool print_stats = true;   /**< Exibe raios por segundo e o histograma dos caminhos ao final de cada renderização. */
+
     /**
      * @brief Renderiza uma cena e salva a imagem resultante em um arquivo PNG.
      * 
      * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela com os materiais referenciados pelos objetos da cena.
      * @param filename Nome do arquivo PNG gerado.
      */
-    void render(const hittable& world, const char *filename) {
-        initialize();
+    void render(const hittable& world, const material_table& materials, const char *filename) {
+        render(world, materials);
 
-        std::vector<unsigned char> image_data = std::vector<unsigned char>(image_width * image_height * 4);
-        for (int j = 0; j < image_height; ++j) {
-            for (int i = 0; i < image_width; ++i) {
-                color pixel_color(0,0,0);
-                for (int sample = 0; sample < samples_per_pixel; ++sample) {
-                    ray r = get_ray(i, j);
-                    pixel_color += ray_color(r, max_depth, world);
-                    // Mapeie a cor para valores de 0 a 255 e adicione ao vetor image_data
-                    image_data[(i + j * image_width) * 4] = static_cast<unsigned char>(255.999 * pixel_color.x());
-                    image_data[(i + j * image_width) * 4 + 1] = static_cast<unsigned char>(255.999 * pixel_color.y());
-                    image_data[(i + j * image_width) * 4 + 2] = static_cast<unsigned char>(255.999 * pixel_color.z());
-                    image_data[(i + j * image_width) * 4 + 3] = 255;  // Alpha (totalmente opaco)
-                }
-            }
-        }
+        std::vector<unsigned char> image_data(accumulation.size());
+        resolve_image(accumulation, image_data);
 
         ImageIO camIO(image_width, image_height, image_data);
 
         camIO.save_png(filename);
     }
 
+    /**
+     * @brief Renderiza uma cena no buffer HDR da câmera (`hdr_buffer`).
+     * 
+     * A imagem é dividida em blocos de `tile_size` x `tile_size` pixels, distribuídos entre
+     * `threads` threads com roubo de trabalho. O gerador aleatório é reiniciado a partir do
+     * pixel, da amostra e do rebatimento, então a imagem é a mesma para qualquer quantidade de threads.
+     * As amostras são somadas em um buffer HDR de `float`, que a versão com arquivo converte
+     * para 8 bits em uma única passada (`resolve_image`). Ao final, informa a quantidade de raios traçados, a taxa de raios por segundo e o
+     * histograma do comprimento dos caminhos (também disponível em `last_render_stats`).
+     * 
+     * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela com os materiais referenciados pelos objetos da cena.
+     */
+    void render(const hittable& world, const material_table& materials) {
+        initialize();
+
+        accumulation.assign(static_cast<size_t>(image_width) * image_height * 4, 0.0f);
+
+        int tiles_x = (image_width + tile_size - 1) / tile_size;
+        int tiles_y = (image_height + tile_size - 1) / tile_size;
+
+        stats = path_stats();
+        std::mutex stats_lock;
+        auto start = std::chrono::steady_clock::now();
+
+        parallel_for_tasks(tiles_x * tiles_y, threads, [&](int tile, int) {
+            path_stats tile_stats;
+            if (wavefront && !adaptive)
+                tile_stats = render_tile_wavefront(world, materials, tile % tiles_x, tile / tiles_x, accumulation);
+            else if (packet_size == 4 && !adaptive)
+                tile_stats = render_tile_packets<4>(world, materials, tile % tiles_x, tile / tiles_x, accumulation);
+            else if (packet_size == 8 && !adaptive)
+                tile_stats = render_tile_packets<8>(world, materials, tile % tiles_x, tile / tiles_x, accumulation);
+            else
+                tile_stats = render_tile(world, materials, tile % tiles_x, tile / tiles_x, accumulation);
+            std::lock_guard<std::mutex> guard(stats_lock);
+            stats.merge(tile_stats);
+        });
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (!print_stats)
+            return;
+
+        std::cout << "Raios: " << stats.rays << " em " << elapsed.count() << " s ("
+                  << stats.rays / elapsed.count() / 1e6 << " Mraios/s)" << std::endl;
+        std::cout << "Caminhos por comprimento:";
+        for (size_t length = 1; length < stats.lengths.size(); length++)
+            std::cout << " " << length << ":" << stats.lengths[length];
+        std::cout << std::endl;
+        if (adaptive)
+            std::cout << "Amostras: " << stats.samples << " (média de "
+                      << static_cast<double>(stats.samples) / (image_width * image_height) << " por pixel)" << std::endl;
+    }
+
+    /**
+     * @brief Retorna as estatísticas da última renderização.
+     * 
+     * @return const path_stats& Raios traçados e histograma do comprimento dos caminhos.
+     */
+    const path_stats& last_render_stats() const { return stats; }
+
+    /**
+     * @brief Retorna o buffer HDR da última renderização.
+     * 
+     * Cada pixel ocupa 4 `float`, em ordem de linhas: a soma das amostras (radiância linear)
+     * em R, G e B e a quantidade de amostras em A.
+     * 
+     * @return const std::vector<float>& Buffer de acumulação.
+     */
+    const std::vector<float>& hdr_buffer() const { return accumulation; }
+
+    /**
+     * @brief Salva um mapa de calor com a quantidade de amostras de cada pixel da última renderização.
+     * 
+     * Pixels azuis receberam poucas amostras e pixels vermelhos chegaram a `samples_per_pixel`.
+     * 
+     * @param filename Nome do arquivo PNG gerado.
+     */
+    void save_sample_heatmap(const char *filename) const {
+        std::vector<unsigned char> heatmap(accumulation.size());
+        for (size_t i = 0; i < accumulation.size(); i += 4) {
+            double t = accumulation[i + 3] / samples_per_pixel;
+            heatmap[i]     = static_cast<unsigned char>(255.999 * t);
+            heatmap[i + 1] = static_cast<unsigned char>(255.999 * (1.0 - fabs(2.0 * t - 1.0)));
+            heatmap[i + 2] = static_cast<unsigned char>(255.999 * (1.0 - t));
+            heatmap[i + 3] = 255;
+        }
+
+        ImageIO heatmapIO(image_width, image_height, heatmap);
+        heatmapIO.save_png(filename);
+    }
+
   private:
     int    image_height;    /**< Altura da imagem renderizada. */
     point3 center;          /**< Centro da câmera. */
@@ -93,6 +226,12 @@ class camera {
     vec3   u, v, w;         /**< Vetores de base do sistema de coordenadas da câmera. */
     vec3   defocus_disk_u;  /**< Raio horizontal do disco de desfoque. */
     vec3   defocus_disk_v;  /**< Raio vertical do disco de desfoque. */
+    path_stats stats;       /**< Estatísticas da última renderização. */
+    std::vector<float> accumulation; /**< Buffer HDR da última renderização (RGB somado e quantidade de amostras). */
+
+    static const int tile_size = 16; /**< Lado, em pixels, de cada bloco de renderização. */
+    static const int camera_dimensions = 4; /**< Dimensões do amostrador usadas pelo pixel e pela lente. */
+    static const int bounce_dimensions = 4; /**< Dimensões do amostrador usadas por rebatimento. */
 
     /**
      * @brief Inicializa a cena da câmera.
@@ -132,18 +271,152 @@ class camera {
         defocus_disk_v = v * defocus_radius;
     }
 
+    /**
+     * @brief Renderiza os pixels de um bloco da imagem.
+     * 
+     * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela de materiais da cena.
+     * @param tile_x Coluna do bloco.
+     * @param tile_y Linha do bloco.
+     * @param hdr Buffer de acumulação da imagem.
+     * @return path_stats Estatísticas dos caminhos traçados no bloco.
+     */
+    path_stats render_tile(const hittable& world, const material_table& materials, int tile_x, int tile_y,
+                           std::vector<float>& hdr) const {
+        path_stats tile_stats;
+        int j_end = std::min((tile_y + 1) * tile_size, image_height);
+        int i_end = std::min((tile_x + 1) * tile_size, image_width);
+
+        for (int j = tile_y * tile_size; j < j_end; ++j) {
+            for (int i = tile_x * tile_size; i < i_end; ++i) {
+                color pixel_color(0,0,0);
+                uint64_t pixel = static_cast<uint64_t>(i) + static_cast<uint64_t>(j) * image_width;
+                int samples = 0;
+                double mean = 0, m2 = 0;  // Média e variância (Welford) da luminância das amostras.
+                while (samples < samples_per_pixel) {
+                    seed_random(pixel, samples, 0);
+                    sample_stream u = {pixel_sampler.get(), i, j, samples, 0};
+                    ray r = get_ray(i, j, u);
+                    color sample_color = ray_color(r, world, materials, pixel, u, tile_stats);
+                    pixel_color += sample_color;
+                    samples++;
+
+                    if (adaptive) {
+                        double y = luminance(sample_color);
+                        double delta = y - mean;
+                        mean += delta / samples;
+                        m2 += delta * (y - mean);
+                        if (samples >= std::max(min_samples, 2) && converged(samples, mean, m2))
+                            break;
+                    }
+                }
+                tile_stats.samples += samples;
+
+                float* sum = &hdr[(i + static_cast<size_t>(j) * image_width) * 4];
+                sum[0] = static_cast<float>(pixel_color.x());
+                sum[1] = static_cast<float>(pixel_color.y());
+                sum[2] = static_cast<float>(pixel_color.z());
+                sum[3] = static_cast<float>(samples);
+            }
+        }
+        return tile_stats;
+    }
+
+    /**
+     * @brief Renderiza os pixels de um bloco da imagem com os raios primários em pacotes de `N`.
+     * 
+     * Os raios da câmera de `N` pixels vizinhos de uma linha, para a mesma amostra, percorrem a
+     * cena juntos (`hittable::intersect_packet`). Depois do primeiro rebatimento os raios deixam
+     * de ser coerentes, então cada caminho continua sozinho em `ray_color`. Os números aleatórios
+     * e a ordem das somas são os mesmos de `render_tile`, então a imagem é idêntica.
+     * 
+     * @tparam N Quantidade de raios por pacote.
+     * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela de materiais da cena.
+     * @param tile_x Coluna do bloco.
+     * @param tile_y Linha do bloco.
+     * @param hdr Buffer de acumulação da imagem.
+     * @return path_stats Estatísticas dos caminhos traçados no bloco.
+     */
+    template <int N>
+    path_stats render_tile_packets(const hittable& world, const material_table& materials, int tile_x, int tile_y,
+                                   std::vector<float>& hdr) const {
+        path_stats tile_stats;
+        int j_end = std::min((tile_y + 1) * tile_size, image_height);
+        int i_end = std::min((tile_x + 1) * tile_size, image_width);
+
+        for (int j = tile_y * tile_size; j < j_end; ++j) {
+            for (int i0 = tile_x * tile_size; i0 < i_end; i0 += N) {
+                const int lanes = std::min(N, i_end - i0);
+                color pixel_color[N];
+                sample_stream u[N];
+                ray_packet<N> packet;
+
+                for (int s = 0; s < samples_per_pixel; s++) {
+                    for (int lane = 0; lane < N; lane++) {
+                        if (lane >= lanes) {
+                            packet.disable(lane);
+                            continue;
+                        }
+                        uint64_t pixel = static_cast<uint64_t>(i0 + lane) + static_cast<uint64_t>(j) * image_width;
+                        seed_random(pixel, s, 0);
+                        u[lane] = {pixel_sampler.get(), i0 + lane, j, s, 0};
+                        packet.set(lane, get_ray(i0 + lane, j, u[lane]));
+                    }
+
+                    world.intersect_packet(packet);
+
+                    for (int lane = 0; lane < lanes; lane++) {
+                        uint64_t pixel = static_cast<uint64_t>(i0 + lane) + static_cast<uint64_t>(j) * image_width;
+                        surface_hit primary = {static_cast<real>(packet.tmax[lane]), packet.object[lane], packet.prim[lane],
+                                               packet.u[lane], packet.v[lane]};
+                        pixel_color[lane] += ray_color(packet.get_ray(lane), world, materials, pixel, u[lane],
+                                                       tile_stats, &primary);
+                    }
+                }
+
+                for (int lane = 0; lane < lanes; lane++) {
+                    float* sum = &hdr[(i0 + lane + static_cast<size_t>(j) * image_width) * 4];
+                    sum[0] = static_cast<float>(pixel_color[lane].x());
+                    sum[1] = static_cast<float>(pixel_color[lane].y());
+                    sum[2] = static_cast<float>(pixel_color[lane].z());
+                    sum[3] = static_cast<float>(samples_per_pixel);
+                }
+                tile_stats.samples += static_cast<uint64_t>(lanes) * samples_per_pixel;
+            }
+        }
+        return tile_stats;
+    }
+
+    /**
+     * @brief Verifica se a estimativa de um pixel já atingiu o ruído desejado.
+     * 
+     * O erro padrão da média da luminância é levado para o espaço gamma pela derivada de
+     * `linear_to_gamma`, para que regiões escuras e claras sejam comparadas como são vistas.
+     * 
+     * @param samples Quantidade de amostras do pixel.
+     * @param mean Média da luminância das amostras.
+     * @param m2 Soma dos quadrados dos desvios em relação à média.
+     * @return true Se o erro estimado está abaixo de `noise_threshold`.
+     */
+    bool converged(int samples, double mean, double m2) const {
+        double standard_error = sqrt(m2 / (samples - 1) / samples);
+        return standard_error / (2.0 * sqrt(std::max(mean, 1e-4))) < noise_threshold;
+    }
+
     /**
      * @brief Obtém um raio na posição (i, j) da imagem.
      * 
      * @param i Índice horizontal do pixel.
      * @param j Índice vertical do pixel.
+     * @param u Amostras da câmera (dimensões 0 e 1 no pixel, 2 e 3 na lente).
      * @return ray Raio associado à posição do pixel.
      */
-    ray get_ray(int i, int j) const {
+    ray get_ray(int i, int j, sample_stream& u) const {
         auto pixel_center = pixel00_loc + (i * pixel_delta_u) + (j * pixel_delta_v);
-        auto pixel_sample = pixel_center + pixel_sample_square();
+        auto pixel_sample = pixel_center + pixel_sample_square(u);
 
-        auto ray_origin = (defocus_angle <= 0) ? center : defocus_disk_sample();
+        auto ray_origin = (defocus_angle <= 0) ? center : defocus_disk_sample(u);
         auto ray_direction = pixel_sample - ray_origin;
 
         return ray(ray_origin, ray_direction);
@@ -152,51 +425,325 @@ class camera {
     /**
      * @brief Retorna uma amostra aleatória no quadrado ao redor de um pixel.
      * 
+     * @param u Amostras da câmera.
      * @return vec3 Amostra no quadrado ao redor de um pixel.
      */
-    vec3 pixel_sample_square() const {
-        auto px = -0.5 + random_double();
-        auto py = -0.5 + random_double();
+    vec3 pixel_sample_square(sample_stream& u) const {
+        u.dimension = 0;
+        auto px = -0.5 + u.next();
+        auto py = -0.5 + u.next();
         return (px * pixel_delta_u) + (py * pixel_delta_v);
     }
 
     /**
      * @brief Retorna uma amostra aleatória do disco de desfoque da câmera.
      * 
+     * @param u Amostras da câmera.
      * @return point3 Amostra aleatória do disco de desfoque.
      */
-    point3 defocus_disk_sample() const  {
-        auto p = random_in_unit_disk();
+    point3 defocus_disk_sample(sample_stream& u) const  {
+        u.dimension = 2;
+        auto p = random_in_unit_disk(u);
         return center + (p[0] * defocus_disk_u) + (p[1] * defocus_disk_v);
     }
 
     /**
      * @brief Calcula a cor do raio, considerando interseções com objetos da cena.
      * 
+     * O caminho é seguido iterativamente, acumulando a atenuação (`throughput`) de cada
+     * rebatimento, até escapar para o céu, ser absorvido ou ser encerrado pela roleta russa.
+     * 
+     * Cada rebatimento usa um bloco fixo de `bounce_dimensions` dimensões do amostrador, depois
+     * das 4 dimensões da câmera: as primeiras para o material e a última para a roleta russa.
+     * 
      * @param r Raio lançado na cena.
-     * @param depth Profundidade atual de reflexão.
      * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela de materiais da cena.
+     * @param pixel Índice do pixel, usado para semear o gerador aleatório.
+     * @param u Amostras do caminho.
+     * @param stats Estatísticas dos caminhos traçados.
+     * @param primary Interseção do raio `r` já calculada em um pacote (objeto nulo se não atingiu
+     *                nada), ou nullptr para calculá-la aqui.
      * @return color Cor resultante do raio na cena.
      */
-    color ray_color(const ray& r, int depth, const hittable& world) const {
-        if (depth <= 0)
-            return color(0,0,0);
+    color ray_color(ray r, const hittable& world, const material_table& materials,
+                    uint64_t pixel, sample_stream& u, path_stats& stats,
+                    const surface_hit* primary = nullptr) const {
+        color throughput(1.0, 1.0, 1.0);
+
+        for (int bounce = 1; bounce <= max_depth; bounce++) {
+            hit_record rec;
+            stats.rays++;
+
+            bool hit;
+            if (bounce == 1 && primary) {
+                hit = primary->object != nullptr;
+                if (hit)
+                    primary->object->shade(r, *primary, rec);
+            } else {
+                hit = world.hit(r, interval(0, infinity), rec);
+            }
 
-        hit_record rec;
+            if (!hit) {
+                stats.record(bounce);
+                return throughput * sky_color(r);
+            }
 
-        if (world.hit(r, interval(0.001, infinity), rec)) {            
             ray scattered;
             color attenuation;
-            if (rec.mat->scatter(r, rec, attenuation, scattered))
-                return attenuation * ray_color(scattered, depth-1, world);
-            
-            return color(0,0,0);
+            seed_random(pixel, u.sample, bounce);
+            u.dimension = first_bounce_dimension(bounce);
+            if (!materials.scatter(rec.mat, r, rec, attenuation, scattered, u)
+                || !survives_roulette(bounce, attenuation, throughput, u)) {
+                stats.record(bounce);
+                return color(0,0,0);
+            }
+
+            r = scattered;
         }
 
+        stats.record(max_depth);
+        return color(0,0,0);
+    }
+
+    /**
+     * @brief Retorna a cor do céu na direção de um raio.
+     * 
+     * @param r Raio que escapou da cena.
+     * @return color Gradiente do branco (horizonte) ao azul (zênite).
+     */
+    color sky_color(const ray& r) const {
         vec3 unit_direction = unit_vector(r.direction());
         auto a = 0.5*(unit_direction.y() + 1.0);
         return (1.0-a)*color(1.0, 1.0, 1.0) + a*color(0.5, 0.7, 1.0);
     }
+
+    /**
+     * @brief Retorna a primeira dimensão do amostrador usada por um rebatimento.
+     */
+    static int first_bounce_dimension(int bounce) {
+        return camera_dimensions + (bounce - 1) * bounce_dimensions;
+    }
+
+    /**
+     * @brief Aplica a atenuação de um rebatimento e a roleta russa ao caminho.
+     * 
+     * A partir de `roulette_depth` rebatimentos, o caminho sobrevive com probabilidade igual à
+     * maior componente do `throughput` (até 0,95) e, se sobreviver, é compensado por essa
+     * probabilidade, o que mantém o valor esperado da imagem.
+     * 
+     * @param bounce Número do rebatimento.
+     * @param attenuation Atenuação do material atingido.
+     * @param throughput Atenuação acumulada do caminho, atualizada.
+     * @param u Amostras do caminho.
+     * @return true Se o caminho continua.
+     */
+    bool survives_roulette(int bounce, const color& attenuation, color& throughput, sample_stream& u) const {
+        throughput = throughput * attenuation;
+        if (roulette_depth <= 0 || bounce < roulette_depth)
+            return true;
+
+        real survival = std::min(real(0.95), std::max(throughput.x(), std::max(throughput.y(), throughput.z())));
+        u.dimension = first_bounce_dimension(bounce) + bounce_dimensions - 1;
+        if (u.next() >= survival)
+            return false;
+        throughput = throughput / survival;
+        return true;
+    }
+
+    /**
+     * @brief Renderiza os pixels de um bloco da imagem em frente de onda (wavefront).
+     * 
+     * Todos os caminhos do bloco (pixels x amostras) avançam juntos, um rebatimento por vez,
+     * em estágios que percorrem filas SoA inteiras: geração dos raios da câmera, interseção,
+     * sombreamento da superfície, espalhamento agrupado por tipo de material e montagem da fila
+     * do próximo rebatimento. Os números aleatórios dependem apenas do pixel, da amostra e do
+     * rebatimento, então a imagem é idêntica à de `render_tile`.
+     * 
+     * @param world Lista de objetos presentes na cena.
+     * @param materials Tabela de materiais da cena.
+     * @param tile_x Coluna do bloco.
+     * @param tile_y Linha do bloco.
+     * @param hdr Buffer de acumulação da imagem.
+     * @return path_stats Estatísticas dos caminhos traçados no bloco.
+     */
+    path_stats render_tile_wavefront(const hittable& world, const material_table& materials, int tile_x, int tile_y,
+                                     std::vector<float>& hdr) const {
+        thread_local wavefront_queues q;
+        path_stats tile_stats;
+
+        const int x0 = tile_x * tile_size, y0 = tile_y * tile_size;
+        const int width = std::min(x0 + tile_size, image_width) - x0;
+        const int height = std::min(y0 + tile_size, image_height) - y0;
+        const uint32_t path_count = static_cast<uint32_t>(width * height * samples_per_pixel);
+
+        // Estágio de geração: um raio da câmera por caminho, na ordem pixel x amostra.
+        q.rays.clear();
+        q.radiance.assign(path_count, color(0,0,0));
+        for (uint32_t path = 0; path < path_count; path++) {
+            sample_stream u = path_samples(path, x0, y0, width);
+            seed_random(pixel_index(u), u.sample, 0);
+            q.rays.push(get_ray(u.x, u.y, u), color(1.0, 1.0, 1.0), path);
+        }
+
+        for (int bounce = 1; bounce <= max_depth && q.rays.size() > 0; bounce++) {
+            tile_stats.rays += q.rays.size();
+
+            // Estágio de interseção: os raios que escapam recebem a cor do céu.
+            q.hits.clear();
+            for (uint32_t e = 0; e < q.rays.size(); e++) {
+                surface_hit h;
+                ray r = q.rays.get_ray(e);
+                if (world.intersect(r, interval(0, infinity), h)) {
+                    q.hits.push(e, h);
+                } else {
+                    q.radiance[q.rays.path[e]] = q.rays.throughput(e) * sky_color(r);
+                    tile_stats.record(bounce);
+                }
+            }
+
+            // Estágio de sombreamento: ponto, normal e material de cada interseção.
+            q.surfaces.clear();
+            for (size_t k = 0; k < q.hits.size(); k++) {
+                hit_record rec;
+                surface_hit h = q.hits.get(k);
+                h.object->shade(q.rays.get_ray(q.hits.entry[k]), h, rec);
+                q.surfaces.push(q.hits.entry[k], rec);
+            }
+
+            // Ordena as interseções por tipo de material (ordenação por contagem, estável).
+            size_t bucket_start[std::variant_size_v<material> + 1] = {};
+            for (size_t k = 0; k < q.surfaces.size(); k++)
+                bucket_start[materials.kind(q.surfaces.mat[k]) + 1]++;
+            for (size_t kind = 1; kind <= std::variant_size_v<material>; kind++)
+                bucket_start[kind] += bucket_start[kind - 1];
+            q.order.resize(q.surfaces.size());
+            size_t fill[std::variant_size_v<material>];
+            std::copy(bucket_start, bucket_start + std::variant_size_v<material>, fill);
+            for (size_t k = 0; k < q.surfaces.size(); k++)
+                q.order[fill[materials.kind(q.surfaces.mat[k])]++] = static_cast<uint32_t>(k);
+
+            // Estágio de espalhamento, um laço por tipo de material, e montagem do próximo rebatimento.
+            q.next_rays.clear();
+            scatter_by_material(materials, q, bucket_start, bounce, x0, y0, width, tile_stats,
+                                std::make_index_sequence<std::variant_size_v<material>>());
+            std::swap(q.rays, q.next_rays);
+        }
+
+        for (size_t e = 0; e < q.rays.size(); e++)
+            tile_stats.record(max_depth);
+
+        // Soma as amostras de cada pixel na mesma ordem de `render_tile`.
+        for (int j = 0; j < height; j++) {
+            for (int i = 0; i < width; i++) {
+                color pixel_color(0,0,0);
+                uint32_t first = static_cast<uint32_t>((j * width + i) * samples_per_pixel);
+                for (int sample = 0; sample < samples_per_pixel; sample++)
+                    pixel_color += q.radiance[first + sample];
+
+                float* sum = &hdr[(x0 + i + static_cast<size_t>(y0 + j) * image_width) * 4];
+                sum[0] = static_cast<float>(pixel_color.x());
+                sum[1] = static_cast<float>(pixel_color.y());
+                sum[2] = static_cast<float>(pixel_color.z());
+                sum[3] = static_cast<float>(samples_per_pixel);
+            }
+        }
+        tile_stats.samples += path_count;
+        return tile_stats;
+    }
+
+    /**
+     * @brief Executa o estágio de espalhamento para cada tipo de material.
+     */
+    template <size_t... Kind>
+    void scatter_by_material(const material_table& materials, wavefront_queues& q, const size_t* bucket_start,
+                             int bounce, int x0, int y0, int width, path_stats& stats,
+                             std::index_sequence<Kind...>) const {
+        (scatter_material<Kind>(materials, q, bucket_start[Kind], bucket_start[Kind + 1],
+                                bounce, x0, y0, width, stats), ...);
+    }
+
+    /**
+     * @brief Espalha os raios que atingiram materiais de um mesmo tipo.
+     * 
+     * O tipo é conhecido em tempo de compilação, então o laço chama diretamente o `scatter` do
+     * material, sem despacho por interseção.
+     * 
+     * @param materials Tabela de materiais da cena.
+     * @param q Filas do lote.
+     * @param begin Primeira posição de `q.order` com o tipo `Kind`.
+     * @param end Posição seguinte à última com o tipo `Kind`.
+     * @param bounce Número do rebatimento.
+     * @param x0 Coluna do primeiro pixel do bloco.
+     * @param y0 Linha do primeiro pixel do bloco.
+     * @param width Largura do bloco.
+     * @param stats Estatísticas dos caminhos traçados.
+     */
+    template <size_t Kind>
+    void scatter_material(const material_table& materials, wavefront_queues& q, size_t begin, size_t end,
+                          int bounce, int x0, int y0, int width, path_stats& stats) const {
+        for (size_t k = begin; k < end; k++) {
+            uint32_t s = q.order[k];
+            uint32_t e = q.surfaces.entry[s];
+            uint32_t path = q.rays.path[e];
+            const auto& m = std::get<Kind>(materials[q.surfaces.mat[s]]);
+
+            sample_stream u = path_samples(path, x0, y0, width);
+            seed_random(pixel_index(u), u.sample, bounce);
+            u.dimension = first_bounce_dimension(bounce);
+
+            ray scattered;
+            color attenuation;
+            color throughput = q.rays.throughput(e);
+            if (!m.scatter(q.rays.get_ray(e), q.surfaces.get(s), attenuation, scattered, u)
+                || !survives_roulette(bounce, attenuation, throughput, u)) {
+                stats.record(bounce);
+                continue;
+            }
+            q.next_rays.push(scattered, throughput, path);
+        }
+    }
+
+    /**
+     * @brief Retorna o pixel e a amostra de um caminho do lote de um bloco.
+     */
+    sample_stream path_samples(uint32_t path, int x0, int y0, int width) const {
+        int local = static_cast<int>(path) / samples_per_pixel;
+        return {pixel_sampler.get(), x0 + local % width, y0 + local / width,
+                static_cast<int>(path) % samples_per_pixel, 0};
+    }
+
+    /**
+     * @brief Retorna o índice de um pixel na imagem.
+     */
+    uint64_t pixel_index(const sample_stream& u) const {
+        return static_cast<uint64_t>(u.x) + static_cast<uint64_t>(u.y) * image_width;
+    }
 };
 
+/**
+ * @brief Configura os parâmetros de visualização de uma câmera.
+ * 
+ * @param cam Câmera a ser configurada.
+ * @param aspect_ratio Razão entre a largura e a altura da imagem.
+ * @param image_width Largura da imagem em pixels.
+ * @param vfov Ângulo de visão vertical.
+ * @param lookfrom Ponto de onde a câmera está olhando.
+ * @param lookat Ponto para onde a câmera está apontando.
+ * @param vup Direção "para cima" em relação à câmera.
+ * @param defocus_angle Ângulo de variação dos raios através de cada pixel.
+ * @param focus_dist Distância ao plano de foco perfeito.
+ */
+void configure_camera(camera& cam, double aspect_ratio, int image_width, double vfov,
+                      point3 lookfrom, point3 lookat, vec3 vup, double defocus_angle, double focus_dist) {
+    cam.aspect_ratio  = aspect_ratio;
+    cam.image_width   = image_width;
+    cam.vfov          = vfov;
+    cam.lookfrom      = lookfrom;
+    cam.lookat        = lookat;
+    cam.vup           = vup;
+    cam.defocus_angle = defocus_angle;
+    cam.focus_dist    = focus_dist;
+}
+
 #endif
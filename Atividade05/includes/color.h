@@ -7,8 +7,15 @@
 #define COLOR_H
 
 #include "../../Atividade02/includes/vec3.h"
-#include "../../Atividade02/includes/vec3.cpp"
+#include "./simd_dispatch.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
+
+#if RT_X86_DISPATCH
+#include <immintrin.h>
+#endif
 
 using color = vec3;
 
@@ -23,6 +30,16 @@ inline double linear_to_gamma(double linear_component)
     return sqrt(linear_component);
 }
 
+/**
+ * @brief Calcula a luminância (Rec. 709) de uma cor linear.
+ * 
+ * @param c Cor linear.
+ * @return double Luminância da cor.
+ */
+inline double luminance(const color& c) {
+    return 0.2126 * c.x() + 0.7152 * c.y() + 0.0722 * c.z();
+}
+
 /**
  * @brief Escreve a cor de um pixel em um formato de imagem (PPM).
  * 
@@ -30,7 +47,7 @@ inline double linear_to_gamma(double linear_component)
  * @param pixel_color Vetor de cor representando a cor do pixel.
  * @param samples_per_pixel Número de amostras por pixel na imagem.
  */
-void write_color(std::ostream &out, color pixel_color, int samples_per_pixel) {
+inline void write_color(std::ostream &out, color pixel_color, int samples_per_pixel) {
     auto r = pixel_color.x();
     auto g = pixel_color.y();
     auto b = pixel_color.z();
@@ -52,4 +69,114 @@ void write_color(std::ostream &out, color pixel_color, int samples_per_pixel) {
         << static_cast<int>(256 * intensity.clamp(b)) << '\n';
 }
 
+#if RT_X86_DISPATCH
+/**
+ * @brief Converte um pixel do buffer de acumulação para inteiros (R, G, B e contagem descartável) com SSE.
+ */
+RT_TARGET("sse2") inline __m128i resolve_pixel_sse2(const float* sum) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 value = _mm_loadu_ps(sum);
+    __m128 count = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+    // Pixels sem amostras ficam pretos; max(x, 0) também descarta NaN.
+    value = _mm_and_ps(_mm_div_ps(value, count), _mm_cmpgt_ps(count, zero));
+    value = _mm_max_ps(value, zero);
+    value = _mm_min_ps(_mm_sqrt_ps(value), _mm_set1_ps(0.999f));
+    return _mm_cvttps_epi32(_mm_mul_ps(value, _mm_set1_ps(256.0f)));
+}
+
+/**
+ * @brief Converte os pixels em grupos de 4 com SSE.
+ *
+ * @return size_t Quantidade de pixels convertidos.
+ */
+RT_TARGET("sse2") inline size_t resolve_pixels_sse2(const float* accumulation, unsigned char* rgba, size_t pixels) {
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        const float* sum = accumulation + 4 * i;
+        __m128i low = _mm_packs_epi32(resolve_pixel_sse2(sum), resolve_pixel_sse2(sum + 4));
+        __m128i high = _mm_packs_epi32(resolve_pixel_sse2(sum + 8), resolve_pixel_sse2(sum + 12));
+        __m128i bytes = _mm_or_si128(_mm_packus_epi16(low, high), opaque);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 4 * i), bytes);
+    }
+    return i;
+}
+
+/**
+ * @brief Converte dois pixels consecutivos do buffer de acumulação para inteiros com AVX2.
+ */
+RT_TARGET("avx2") inline __m256i resolve_pixels_pair_avx2(const float* sum) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 value = _mm256_loadu_ps(sum);
+    __m256 count = _mm256_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+    value = _mm256_and_ps(_mm256_div_ps(value, count), _mm256_cmp_ps(count, zero, _CMP_GT_OQ));
+    value = _mm256_max_ps(value, zero);
+    value = _mm256_min_ps(_mm256_sqrt_ps(value), _mm256_set1_ps(0.999f));
+    return _mm256_cvttps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(256.0f)));
+}
+
+/**
+ * @brief Converte os pixels em grupos de 8 com AVX2.
+ *
+ * @return size_t Quantidade de pixels convertidos.
+ */
+RT_TARGET("avx2") inline size_t resolve_pixels_avx2(const float* accumulation, unsigned char* rgba, size_t pixels) {
+    const __m256i opaque = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    // As instruções de empacotamento trabalham em cada metade de 128 bits; os pixels saem na
+    // ordem 0 2 4 6 | 1 3 5 7 e são reordenados no final.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        const float* sum = accumulation + 4 * i;
+        __m256i low = _mm256_packs_epi32(resolve_pixels_pair_avx2(sum), resolve_pixels_pair_avx2(sum + 8));
+        __m256i high = _mm256_packs_epi32(resolve_pixels_pair_avx2(sum + 16), resolve_pixels_pair_avx2(sum + 24));
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 4 * i), _mm256_or_si256(bytes, opaque));
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Converte um buffer de acumulação em ponto flutuante para a imagem RGBA de 8 bits.
+ * 
+ * Cada pixel ocupa 4 `float` no buffer de acumulação: a soma das amostras em R, G e B e a
+ * quantidade de amostras em A. A conversão divide pela quantidade de amostras, aplica a
+ * correção gamma, limita os valores e quantiza para bytes, processando 8 pixels por iteração
+ * com AVX2 ou 4 com SSE, conforme o nível SIMD ativo (`active_simd_level`).
+ * 
+ * @param accumulation Buffer de acumulação (4 `float` por pixel).
+ * @param rgba Imagem RGBA de saída (4 bytes por pixel), com o mesmo número de pixels.
+ */
+inline void resolve_image(const std::vector<float>& accumulation, std::vector<unsigned char>& rgba) {
+    const size_t pixels = accumulation.size() / 4;
+    size_t i = 0;
+
+#if RT_X86_DISPATCH
+    switch (active_simd_level()) {
+        case simd_level::avx512:
+        case simd_level::avx2:
+            i = resolve_pixels_avx2(accumulation.data(), rgba.data(), pixels);
+            break;
+        case simd_level::sse42:
+        case simd_level::sse2:
+            i = resolve_pixels_sse2(accumulation.data(), rgba.data(), pixels);
+            break;
+        default:
+            break;
+    }
+#endif
+
+    // Mesmas operações, em float, dos kernels SIMD, para que todos os níveis gerem os mesmos bytes.
+    for (; i < pixels; i++) {
+        const float* sum = &accumulation[4 * i];
+        for (int c = 0; c < 3; c++) {
+            float value = sum[3] > 0 ? sum[c] / sum[3] : 0.0f;
+            value = value > 0 ? std::sqrt(value) : 0.0f;
+            rgba[4 * i + c] = static_cast<unsigned char>(std::min(value, 0.999f) * 256.0f);
+        }
+        rgba[4 * i + 3] = 255;
+    }
+}
+
 #endif
@@ -7,8 +7,14 @@
 #define HITTABLE_H
 
 #include "./utils.h"
+#include "./aabb.h"
+#include "./ray_packet.h"
+#include "./ray_offset.h"
 
-class material;
+/**
+ * @brief Identificador compacto de um material na `material_table`.
+ */
+using material_id = uint32_t;
 
 /**
  * @brief Classe que armazena informações sobre uma interseção de raio com um objeto.
@@ -19,10 +25,12 @@ class material;
 class hit_record {
   public:
     point3 p;                       /**< Ponto de interseção */
-    vec3 normal;                    /**< Vetor normal à superfície */
-    shared_ptr<material> mat;        /**< Material associado ao objeto */
-    double t;                        /**< Parâmetro t do raio na interseção */
+    vec3 normal;                    /**< Vetor normal de sombreamento, usado pelos materiais */
+    vec3 geometric_normal;          /**< Normal geométrica, no mesmo lado de `normal`; usada por `spawn_ray` */
+    material_id mat;                 /**< Material associado ao objeto */
+    real t;                          /**< Parâmetro t do raio na interseção */
     bool front_face;                 /**< Indica se a interseção ocorreu na face frontal do objeto */
+    real p_error = 0;                /**< Erro absoluto máximo de `p`, somado ao deslocamento de `spawn_ray` */
 
     /**
      * @brief Define a normal da face com base no raio e na normal externa.
@@ -33,32 +41,99 @@ class hit_record {
     void set_face_normal(const ray& r, const vec3& outward_normal) {
         front_face = dot(r.direction(), outward_normal) < 0;
         normal = front_face ? outward_normal : -outward_normal;
+        geometric_normal = normal;
     }
 
     /**
-     * @brief Define a normal da face com base no raio, na normal externa e na cor da normal.
+     * @brief Define as normais da face quando a normal de sombreamento difere da geométrica.
+     * 
+     * A normal geométrica é virada para o lado da normal de sombreamento (a ordem dos vértices
+     * pode não concordar com as normais do arquivo) e decide qual face foi atingida.
      * 
      * @param r Raio incidente.
-     * @param outward_normal Normal externa ao objeto.
-     * @param color_normal Cor associada à normal.
+     * @param outward_normal Normal geométrica unitária da superfície.
+     * @param shading_normal Normal de sombreamento externa ao objeto.
      */
-    void set_face_normal(const ray& r, const vec3& outward_normal, const vec3& color_normal) {
-        front_face = dot(r.direction(), outward_normal) < 0;
-        normal = front_face ? color_normal : -color_normal;
+    void set_face_normal(const ray& r, const vec3& outward_normal, const vec3& shading_normal) {
+        const vec3 n = dot(outward_normal, shading_normal) < 0 ? -outward_normal : outward_normal;
+        front_face = dot(r.direction(), n) < 0;
+        normal = front_face ? shading_normal : -shading_normal;
+        geometric_normal = front_face ? n : -n;
     }
+
+    /**
+     * @brief Cria um raio que parte do ponto de interseção sem reinterceptar a própria superfície.
+     * 
+     * A origem é afastada `p_error` ao longo da normal geométrica e deslocada (`offset_ray_origin`)
+     * para o lado da superfície para onde o raio segue, então o raio é testado a partir de t = 0.
+     * A normal de sombreamento não serve aqui: interpolada, ela pode apontar para dentro da
+     * superfície real e levar a origem para o lado errado.
+     * 
+     * @param direction Direção do raio.
+     * @return ray Raio com origem deslocada.
+     */
+    ray spawn_ray(const vec3& direction) const {
+        const vec3 side = dot(direction, geometric_normal) > 0 ? geometric_normal : -geometric_normal;
+        return ray(offset_ray_origin(p + p_error * side, side), direction);
+    }
+};
+
+class hittable;
+
+/**
+ * @brief Resultado da fase de travessia: apenas o necessário para escolher a interseção mais próxima.
+ * 
+ * O ponto, a normal e o material só são calculados depois, uma única vez, pelo objeto
+ * atingido (`hittable::shade`).
+ */
+struct surface_hit {
+    real t;                   /**< Parâmetro t do raio na interseção. */
+    const hittable* object;   /**< Primitiva atingida. */
+    uint32_t prim;            /**< Índice do triângulo dentro da primitiva (0 se não se aplica). */
+    float u, v;               /**< Coordenadas baricêntricas da interseção. */
+};
+
+/**
+ * @brief Contadores das consultas de oclusão (`hittable::occluded`) de uma thread.
+ * 
+ * Mostram quanto da cena cada consulta percorre antes de encontrar um bloqueio, para comparar
+ * com a busca da interseção mais próxima.
+ */
+struct occlusion_stats {
+    uint64_t queries = 0;    /**< Consultas realizadas. */
+    uint64_t occluded = 0;   /**< Consultas em que o segmento estava bloqueado. */
+    uint64_t nodes = 0;      /**< Nós de BVH visitados. */
+    uint64_t primitives = 0; /**< Testes de primitivas (esferas, triângulos ou blocos de triângulos). */
+
+    /**
+     * @brief Zera os contadores.
+     */
+    void reset() { *this = occlusion_stats(); }
 };
 
+/**
+ * @brief Retorna os contadores de oclusão da thread atual.
+ * 
+ * @return occlusion_stats& Contadores da thread.
+ */
+inline occlusion_stats& occlusion_counters() {
+    thread_local occlusion_stats counters;
+    return counters;
+}
+
 /**
  * @brief Classe base abstrata que representa um objeto interceptável por raios.
  * 
  * A classe Hittable define uma interface para objetos que podem ser atingidos por raios.
+ * A interseção é feita em duas fases: `intersect` encontra a interseção mais próxima sem
+ * montar o `hit_record`, e `shade` monta o registro completo apenas para ela.
  */
 class hittable {
   public:
     virtual ~hittable() = default;
 
     /**
-     * @brief Método virtual puro para determinar a interseção entre um raio e o objeto.
+     * @brief Determina a interseção mais próxima entre um raio e o objeto e monta o seu registro.
      * 
      * @param r Raio a ser verificado quanto à interseção.
      * @param ray_t Dados auxiliares de intervalo do raio.
@@ -66,7 +141,109 @@ class hittable {
      * @return true Se houve uma interseção.
      * @return false Se não houve interseção.
      */
-    virtual bool hit(const ray& r, interval ray_t, hit_record& rec) const = 0;
+    bool hit(const ray& r, interval ray_t, hit_record& rec) const {
+        surface_hit h;
+        if (!intersect(r, ray_t, h))
+            return false;
+        h.object->shade(r, h, rec);
+        return true;
+    }
+
+    /**
+     * @brief Verifica se algum objeto bloqueia o segmento `ray_t` do raio.
+     * 
+     * Usada em testes de visibilidade (raios de sombra, oclusão ambiente, amostragem de luzes):
+     * a busca termina na primeira interseção encontrada, sem procurar a mais próxima nem montar
+     * o `hit_record`. Cada chamada é contada em `occlusion_counters`.
+     * 
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio que deve estar livre.
+     * @return true Se algum objeto intercepta o segmento.
+     * @return false Se o segmento está livre.
+     */
+    bool occluded(const ray& r, interval ray_t) const {
+        occlusion_stats& counters = occlusion_counters();
+        counters.queries++;
+        bool blocked = any_hit(r, ray_t);
+        if (blocked)
+            counters.occluded++;
+        return blocked;
+    }
+
+    /**
+     * @brief Busca qualquer interseção dentro de `ray_t`, podendo parar na primeira encontrada.
+     * 
+     * A versão padrão usa `intersect`; listas e hierarquias retornam assim que um filho é atingido.
+     * 
+     * @param r Raio a ser verificado.
+     * @param ray_t Dados auxiliares de intervalo do raio.
+     * @return true Se houve alguma interseção.
+     * @return false Se não houve interseção.
+     */
+    virtual bool any_hit(const ray& r, interval ray_t) const {
+        surface_hit h;
+        return intersect(r, ray_t, h);
+    }
+
+    /**
+     * @brief Método virtual puro que busca a interseção mais próxima, sem calcular dados de sombreamento.
+     * 
+     * Só escreve em `h` quando encontra uma interseção dentro de `ray_t`.
+     * 
+     * @param r Raio a ser verificado quanto à interseção.
+     * @param ray_t Dados auxiliares de intervalo do raio.
+     * @param h Parâmetro t, primitiva e coordenadas baricêntricas da interseção.
+     * @return true Se houve uma interseção.
+     * @return false Se não houve interseção.
+     */
+    virtual bool intersect(const ray& r, interval ray_t, surface_hit& h) const = 0;
+
+    /**
+     * @brief Busca a interseção mais próxima de cada raio de um pacote.
+     * 
+     * Só altera as posições em que encontra uma interseção mais próxima que o `tmax` atual,
+     * reduzindo-o. A versão padrão testa cada raio com `intersect`; esferas, triângulos e as
+     * estruturas que os agrupam testam o pacote inteiro com SIMD.
+     * 
+     * @param packet Pacote de raios.
+     */
+    virtual void intersect_packet(ray_packet4& packet) const { intersect_lanes(packet); }
+
+    /**
+     * @brief Versão de `intersect_packet` para pacotes de 8 raios.
+     * 
+     * @param packet Pacote de raios.
+     */
+    virtual void intersect_packet(ray_packet8& packet) const { intersect_lanes(packet); }
+
+    /**
+     * @brief Método virtual puro que monta o registro completo de uma interseção já escolhida.
+     * 
+     * @param r Raio incidente.
+     * @param h Interseção retornada por `intersect`.
+     * @param rec Registro com ponto, normal e material da interseção.
+     */
+    virtual void shade(const ray& r, const surface_hit& h, hit_record& rec) const = 0;
+
+    /**
+     * @brief Método virtual puro que retorna a caixa delimitadora do objeto.
+     * 
+     * @return aabb Caixa alinhada aos eixos que envolve todo o objeto.
+     */
+    virtual aabb bounding_box() const = 0;
+
+  protected:
+    /**
+     * @brief Testa cada raio ativo do pacote individualmente com `intersect`.
+     */
+    template <int N>
+    void intersect_lanes(ray_packet<N>& packet) const {
+        for (int lane = 0; lane < N; lane++) {
+            surface_hit h = {};
+            if (packet.active(lane) && intersect(packet.get_ray(lane), interval(packet.tmin, packet.tmax[lane]), h))
+                packet.record(lane, h.t, h.object, h.prim, h.u, h.v);
+        }
+    }
 };
 
 #endif
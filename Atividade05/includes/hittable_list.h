@@ -35,7 +35,10 @@ class hittable_list : public hittable {
     /**
      * @brief Elimina todos os objetos interceptáveis armazenados na lista.
      */
-    void clear() { objects.clear(); }
+    void clear() {
+        objects.clear();
+        bbox = aabb::empty;
+    }
 
     /**
      * @brief Adiciona um novo objeto à lista de objetos interceptáveis da cena.
@@ -44,6 +47,7 @@ class hittable_list : public hittable {
      */
     void add(shared_ptr<hittable> object) {
         objects.push_back(object);
+        bbox = aabb(bbox, object->bounding_box());
     }
 
     /**
@@ -51,25 +55,77 @@ class hittable_list : public hittable {
      * 
      * @param r Raio a ser verificado.
      * @param ray_t Dados auxiliares de intervalo do raio.
-     * @param rec Estrutura para armazenamento de interceptações.
+     * @param h Estrutura para armazenamento da interseção mais próxima.
      * @return true Se algum objeto intercepta o raio.
      * @return false Se nenhum objeto intercepta o raio.
      */
-    bool hit(const ray& r, interval ray_t, hit_record& rec) const noexcept override {
-        hit_record temp_rec;
+    bool intersect(const ray& r, interval ray_t, surface_hit& h) const noexcept override {
         auto hit_anything = false;
         auto closest_so_far = ray_t.max;
 
+        // Os objetos só escrevem em `h` quando encontram uma interseção mais próxima.
         for (const auto& object : objects) {
-            if (object->hit(r, interval(ray_t.min, closest_so_far), temp_rec)) {
+            if (object->intersect(r, interval(ray_t.min, closest_so_far), h)) {
                 hit_anything = true;
-                closest_so_far = temp_rec.t;
-                rec = temp_rec;
+                closest_so_far = h.t;
             }
         }
 
         return hit_anything;
     }
+
+    /**
+     * @brief Verifica se algum objeto da lista bloqueia o segmento, parando no primeiro.
+     * 
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio.
+     * @return true Se algum objeto intercepta o segmento.
+     */
+    bool any_hit(const ray& r, interval ray_t) const override {
+        for (const auto& object : objects) {
+            if (object->any_hit(r, ray_t))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Testa um pacote de raios contra todos os objetos da lista.
+     * 
+     * @param packet Pacote de raios.
+     */
+    void intersect_packet(ray_packet4& packet) const override { intersect_objects(packet); }
+    void intersect_packet(ray_packet8& packet) const override { intersect_objects(packet); }
+
+    /**
+     * @brief Repassa o sombreamento para o objeto atingido.
+     * 
+     * @param r Raio incidente.
+     * @param h Interseção retornada por `intersect`.
+     * @param rec Registro de interseptação.
+     */
+    void shade(const ray& r, const surface_hit& h, hit_record& rec) const override {
+        h.object->shade(r, h, rec);
+    }
+
+    /**
+     * @brief Retorna a caixa delimitadora que envolve todos os objetos da lista.
+     * 
+     * @return aabb Caixa delimitadora da lista.
+     */
+    aabb bounding_box() const override { return bbox; }
+
+  private:
+    /**
+     * @brief Repassa o pacote a cada objeto; cada um reduz o `tmax` das posições que atinge.
+     */
+    template <int N>
+    void intersect_objects(ray_packet<N>& packet) const {
+        for (const auto& object : objects)
+            object->intersect_packet(packet);
+    }
+
+    aabb bbox; /**< Caixa delimitadora acumulada dos objetos. */
 };
 
 #endif
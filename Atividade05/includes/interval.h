@@ -15,7 +15,7 @@
  */
 class interval {
   public:
-    double min, max; /**< Valores mínimo e máximo do intervalo */
+    real min, max; /**< Valores mínimo e máximo do intervalo */
 
     /**
      * @brief Construtor padrão que cria um intervalo vazio.
@@ -28,14 +28,23 @@ class interval {
      * @param _min Valor mínimo do intervalo.
      * @param _max Valor máximo do intervalo.
      */
-    interval(double _min, double _max) : min(_min), max(_max) {}
+    interval(real _min, real _max) : min(_min), max(_max) {}
+
+    /**
+     * @brief Construtor que cria o menor intervalo que contém dois intervalos.
+     *
+     * @param a Primeiro intervalo.
+     * @param b Segundo intervalo.
+     */
+    interval(const interval& a, const interval& b)
+      : min(fmin(a.min, b.min)), max(fmax(a.max, b.max)) {}
 
     /**
      * @brief Retorna o tamanho do intervalo.
      * 
-     * @return double 
+     * @return real 
      */
-    double size() const {
+    real size() const {
         return max - min;
     }
 
@@ -45,7 +54,7 @@ class interval {
      * @param delta Valor de aumento.
      * @return interval Novo intervalo expandido.
      */
-    interval expand(double delta) const {
+    interval expand(real delta) const {
         auto padding = delta/2;
         return interval(min - padding, max + padding);
     }
@@ -57,7 +66,7 @@ class interval {
      * @return true Se o valor está no intervalo.
      * @return false Se o valor está fora do intervalo.
      */
-    bool contains(double x) const {
+    bool contains(real x) const {
         return min <= x && x <= max;
     }
 
@@ -68,7 +77,7 @@ class interval {
      * @return true Se o valor está nos arredores do intervalo.
      * @return false Se o valor está dentro do intervalo ou fora dos arredores.
      */
-    bool surrounds(double x) const {
+    bool surrounds(real x) const {
         return min < x && x < max;
     }
 
@@ -76,9 +85,9 @@ class interval {
      * @brief Retorna o valor mais próximo dentro do intervalo.
      * 
      * @param x Valor a ser verificado.
-     * @return double Valor mais próximo dentro do intervalo.
+     * @return real Valor mais próximo dentro do intervalo.
      */
-    double clamp(double x) const {
+    real clamp(real x) const {
         if (x < min) return min;
         if (x > max) return max;
         return x;
@@ -87,7 +96,7 @@ class interval {
     static const interval empty, universe; /**< Intervalos especiais: vazio e universo. */
 };
 
-const interval interval::empty    = interval(+infinity, -infinity); /**< Intervalo vazio. */
-const interval interval::universe = interval(-infinity, +infinity); /**< Intervalo que cobre toda a reta real. */
+inline const interval interval::empty    = interval(+infinity, -infinity); /**< Intervalo vazio. */
+inline const interval interval::universe = interval(-infinity, +infinity); /**< Intervalo que cobre toda a reta real. */
 
 #endif
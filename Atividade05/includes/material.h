@@ -8,42 +8,22 @@
 
 #include "color.h"
 #include "utils.h"
-#include "hittable_list.h"
+#include "hittable.h"
+#include "sampler.h"
+#include <cstdint>
 #include <cstdlib>
-
-/**
- * @brief Classe base abstrata para materiais.
- * 
- * A classe `material` fornece uma interface para diferentes tipos de materiais utilizados em interações
- * de raios com objetos na cena.
- */
-class material {
-  public:
-    virtual ~material() = default;
-
-    /**
-     * @brief Método virtual puro de espalhamento de raio.
-     * 
-     * @param r_in Raio incidente.
-     * @param rec Registro de interseptação.
-     * @param attenuation Atenuação da cor.
-     * @param scattered Raio espalhado.
-     * @return true Se houve espalhamento do raio.
-     * @return false Se não houve espalhamento do raio.
-     */
-    virtual bool scatter(
-        const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered
-    ) const = 0;
-};
+#include <variant>
+#include <vector>
 
 /**
  * @brief Gera um vetor unitário aleatório na esfera.
  * 
+ * @param u Amostras usadas (2 dimensões).
  * @return vec3 Vetor unitário aleatório na esfera.
  */
-vec3 random_unit_vector() {
-    auto a = random_double(0, 2 * pi);
-    auto z = random_double(-1, 1);
+inline vec3 random_unit_vector(sample_stream& u) {
+    auto a = 2 * pi * u.next();
+    auto z = -1 + 2 * u.next();
     auto r = sqrt(1 - z * z);
 
     return vec3(r * cos(a), r * sin(a), z);
@@ -52,7 +32,7 @@ vec3 random_unit_vector() {
 /**
  * @brief Classe que representa um material difuso (lambertiano).
  */
-class lambertian : public material {
+class lambertian {
   public:
     /**
      * @brief Construtor da classe lambertian.
@@ -68,17 +48,17 @@ class lambertian : public material {
      * @param rec Registro de interseptação.
      * @param attenuation Atenuação da cor.
      * @param scattered Raio espalhado.
+     * @param u Amostras do rebatimento.
      * @return true Sempre retorna verdadeiro.
      */
-    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered)
-    const override {
-        auto scatter_direction = rec.normal + random_unit_vector();
+    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered, sample_stream& u) const {
+        auto scatter_direction = rec.normal + random_unit_vector(u);
 
         // Trata direção de espalhamento degenerada
         if (scatter_direction.near_zero())
             scatter_direction = rec.normal;
 
-        scattered = ray(rec.p, scatter_direction);
+        scattered = rec.spawn_ray(scatter_direction);
         attenuation = albedo;
         return true;
     }
@@ -94,28 +74,28 @@ class lambertian : public material {
  * @param normal Normal da superfície.
  * @return vec3 Vetor refletido.
  */
-vec3 reflect(const vec3& v, const vec3& normal) {
+inline vec3 reflect(const vec3& v, const vec3& normal) {
     return v - 2 * dot(v, normal) * normal;
 }
 
 /**
  * @brief Gera um vetor aleatório na esfera unitária.
  * 
+ * Usa uma quantidade fixa de amostras (direção e raio), em vez de rejeição, para que cada
+ * rebatimento consuma sempre as mesmas dimensões do amostrador.
+ * 
+ * @param u Amostras usadas (3 dimensões).
  * @return vec3 Vetor aleatório na esfera unitária.
  */
-vec3 random_in_unit_sphere() {
-    while (true) {
-        auto p = vec3::random(-1, 1);
-        if (p.length_squared() >= 1)
-            continue;
-        return p;
-    }
+inline vec3 random_in_unit_sphere(sample_stream& u) {
+    vec3 direction = random_unit_vector(u);
+    return std::cbrt(u.next()) * direction;
 }
 
 /**
  * @brief Classe que representa um material metálico.
  */
-class metal : public material {
+class metal {
   public:
     /**
      * @brief Construtor da classe metal.
@@ -123,7 +103,7 @@ class metal : public material {
      * @param a Cor do material metálico.
      * @param f Fuzziness (borramento) do material.
      */
-    metal(const color& a, double f) : albedo(a), fuzz(f < 1 ? f : 1) {}
+    metal(const color& a, real f) : albedo(a), fuzz(f < 1 ? f : 1) {}
 
     /**
      * @brief Implementação da função de espalhamento para material metálico.
@@ -132,19 +112,19 @@ class metal : public material {
      * @param rec Registro de interseptação.
      * @param attenuation Atenuação da cor.
      * @param scattered Raio espalhado.
+     * @param u Amostras do rebatimento.
      * @return true Se o raio espalhado é válido.
      */
-    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered)
-    const override {
+    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered, sample_stream& u) const {
         vec3 reflected = reflect(unit_vector(r_in.direction()), rec.normal);
-        scattered = ray(rec.p, reflected + fuzz*random_in_unit_sphere());
+        scattered = rec.spawn_ray(reflected + fuzz*random_in_unit_sphere(u));
         attenuation = albedo;
         return (dot(scattered.direction(), rec.normal) > 0);
     }
 
   private:
     color albedo; /**< Cor do material metálico. */
-    double fuzz;  /**< Fuzziness (borramento) do material. */
+    real fuzz;  /**< Fuzziness (borramento) do material. */
 };
 
 /**
@@ -155,7 +135,7 @@ class metal : public material {
  * @param etai_over_etat Índice de refração.
  * @return vec3 Vetor refratado.
  */
-vec3 refract(const vec3& uv, const vec3& normal, double etai_over_etat) {
+inline vec3 refract(const vec3& uv, const vec3& normal, real etai_over_etat) {
     auto cos_theta = fmin(dot(-uv, normal), 1.0);
     vec3 r_out_perp = etai_over_etat * (uv + cos_theta * normal);
     vec3 r_out_parallel = -sqrt(fabs(1.0 - r_out_perp.length_squared())) * normal;
@@ -165,14 +145,14 @@ vec3 refract(const vec3& uv, const vec3& normal, double etai_over_etat) {
 /**
  * @brief Classe que representa um material de vidro.
  */
-class dielectric : public material {
+class dielectric {
   public:
     /**
      * @brief Construtor da classe dielectric.
      * 
      * @param index_of_refraction Índice de refração do material.
      */
-    dielectric(double index_of_refraction) : ir(index_of_refraction) {}
+    dielectric(real index_of_refraction) : ir(index_of_refraction) {}
 
     /**
      * @brief Implementação da função de espalhamento para material dielétrico (de vidro).
@@ -181,44 +161,114 @@ class dielectric : public material {
      * @param rec Registro de interseptação.
      * @param attenuation Atenuação da cor.
      * @param scattered Raio espalhado.
+     * @param u Amostras do rebatimento.
      * @return true Se o raio espalhado é válido.
      */
-    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered)
-    const override {
+    bool scatter(const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered, sample_stream& u) const {
         attenuation = color(1.0, 1.0, 1.0);
-        double refraction_ratio = rec.front_face ? (1.0/ir) : ir;
+        real refraction_ratio = rec.front_face ? (1.0/ir) : ir;
 
         vec3 unit_direction = unit_vector(r_in.direction());
-        double cos_theta = fmin(dot(-unit_direction, rec.normal), 1.0);
-        double sin_theta = sqrt(1.0 - cos_theta*cos_theta);
+        real cos_theta = fmin(dot(-unit_direction, rec.normal), 1.0);
+        real sin_theta = sqrt(1.0 - cos_theta*cos_theta);
 
         bool cannot_refract = refraction_ratio * sin_theta > 1.0;
         vec3 direction;
 
-        if (cannot_refract || reflectance(cos_theta, refraction_ratio) > random_double())
+        if (cannot_refract || reflectance(cos_theta, refraction_ratio) > u.next())
             direction = reflect(unit_direction, rec.normal);
         else
             direction = refract(unit_direction, rec.normal, refraction_ratio);
 
-        scattered = ray(rec.p, direction);
+        scattered = rec.spawn_ray(direction);
         return true;
     }
 
   private:
-    double ir; /**< Índice de refração do material dielétrico. */
+    real ir; /**< Índice de refração do material dielétrico. */
 
     /**
      * @brief Calcula o coeficiente de reflectância.
      * 
      * @param cosine Cosseno do ângulo de incidência.
      * @param ref_idx Índice de refração.
-     * @return double Coeficiente de reflectância.
+     * @return real Coeficiente de reflectância.
      */
-    static double reflectance(double cosine, double ref_idx) {
+    static real reflectance(real cosine, real ref_idx) {
         auto r0 = (1-ref_idx) / (1+ref_idx);
         r0 = r0*r0;
         return r0 + (1-r0)*pow((1 - cosine),5);
     }
 };
 
+/**
+ * @brief Material de qualquer um dos tipos suportados (união etiquetada).
+ */
+using material = std::variant<lambertian, metal, dielectric>;
+
+/**
+ * @brief Tabela com todos os materiais da cena, endereçados por `material_id`.
+ * 
+ * Os materiais ficam em um vetor contíguo e o espalhamento é despachado com `std::visit`,
+ * sem chamadas virtuais nem contagem de referências durante a renderização.
+ */
+class material_table {
+  public:
+    /**
+     * @brief Adiciona um material à tabela.
+     * 
+     * @param m Material a ser adicionado.
+     * @return material_id Identificador do material.
+     */
+    material_id add(const material& m) {
+        materials.push_back(m);
+        return static_cast<material_id>(materials.size() - 1);
+    }
+
+    /**
+     * @brief Retorna a quantidade de materiais na tabela.
+     * 
+     * @return size_t Quantidade de materiais.
+     */
+    size_t size() const { return materials.size(); }
+
+    /**
+     * @brief Retorna um material da tabela.
+     * 
+     * @param id Identificador do material.
+     * @return const material& Material correspondente.
+     */
+    const material& operator[](material_id id) const { return materials[id]; }
+
+    /**
+     * @brief Retorna o tipo de um material (índice da alternativa em `material`).
+     * 
+     * @param id Identificador do material.
+     * @return size_t 0 para `lambertian`, 1 para `metal` e 2 para `dielectric`.
+     */
+    size_t kind(material_id id) const { return materials[id].index(); }
+
+    /**
+     * @brief Espalha um raio de acordo com o material atingido.
+     * 
+     * @param id Identificador do material.
+     * @param r_in Raio incidente.
+     * @param rec Registro de interseptação.
+     * @param attenuation Atenuação da cor.
+     * @param scattered Raio espalhado.
+     * @param u Amostras do rebatimento.
+     * @return true Se houve espalhamento do raio.
+     * @return false Se não houve espalhamento do raio.
+     */
+    bool scatter(material_id id, const ray& r_in, const hit_record& rec, color& attenuation, ray& scattered,
+                 sample_stream& u) const {
+        return std::visit([&](const auto& m) {
+            return m.scatter(r_in, rec, attenuation, scattered, u);
+        }, materials[id]);
+    }
+
+  private:
+    std::vector<material> materials; /**< Materiais da cena. */
+};
+
 #endif
@@ -0,0 +1,96 @@
+/**
+ * @file ray_offset.h
+ * @brief Arquivo de implementação do deslocamento da origem de raios secundários
+ */
+
+#ifndef RAY_OFFSET_H
+#define RAY_OFFSET_H
+
+#include "./utils.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+/**
+ * @brief Parâmetros do deslocamento para cada precisão.
+ *
+ * O deslocamento é feito somando um número de ULPs à representação inteira de cada coordenada,
+ * então ele cresce com a magnitude do ponto e continua maior que o erro de arredondamento da
+ * interseção em qualquer escala da cena. Em `double` o número de ULPs é 2^29 vezes maior (a
+ * diferença entre as mantissas), o que dá o mesmo deslocamento absoluto nas duas precisões.
+ */
+template <typename T> struct ray_offset_traits;
+
+template <> struct ray_offset_traits<float> {
+    using bits = int32_t;
+    static constexpr float int_scale = 256.0f;
+};
+
+template <> struct ray_offset_traits<double> {
+    using bits = int64_t;
+    static constexpr double int_scale = 256.0 * (1 << 29);
+};
+
+/**
+ * @brief Move `x` por `ulps` unidades na última casa, no sentido do sinal de `ulps`.
+ */
+template <typename T>
+inline T offset_ulps(T x, typename ray_offset_traits<T>::bits ulps) {
+    typename ray_offset_traits<T>::bits i;
+    std::memcpy(&i, &x, sizeof(x));
+    i += x < 0 ? -ulps : ulps;
+    std::memcpy(&x, &i, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Desloca a origem de um raio secundário para fora da superfície que ele deixa.
+ *
+ * Método de Wächter e Binder ("A Fast and Robust Method for Avoiding Self-Intersection", Ray
+ * Tracing Gems, cap. 6): cada coordenada do ponto é movida alguns ULPs no sentido da normal;
+ * perto da origem, onde os ULPs são pequenos demais, é usado um deslocamento absoluto. O raio
+ * resultante pode ser testado a partir de t = 0, sem o `t_min` fixo que falhava em cenas muito
+ * grandes (acne) e cortava interseções legítimas em cenas muito pequenas.
+ *
+ * @param p Ponto de interseção.
+ * @param n Normal da superfície no lado para onde o raio segue (não precisa ser unitária, mas deve ter comprimento próximo de 1).
+ * @return point3 Origem deslocada.
+ */
+inline point3 offset_ray_origin(const point3& p, const vec3& n) {
+    using traits = ray_offset_traits<real>;
+    const real origin = real(1) / 32;
+    const real float_scale = real(1) / 65536;
+
+    point3 result;
+    for (int k = 0; k < 3; k++) {
+        auto ulps = static_cast<traits::bits>(traits::int_scale * n[k]);
+        result[k] = std::fabs(p[k]) < origin ? p[k] + float_scale * n[k] : offset_ulps(p[k], ulps);
+    }
+    return result;
+}
+
+/**
+ * @brief Reconstrói um ponto do triângulo (a, b, c) a partir das coordenadas baricêntricas de b e c.
+ *
+ * O erro de `r.at(t)` cresce com |o| + t|d|, então um ponto calculado longe da origem do raio
+ * pode ficar mais longe do plano que o deslocamento de `offset_ray_origin`. O ponto interpolado
+ * depende apenas dos vértices e fica a poucos ULPs do plano do triângulo.
+ *
+ * @param u Coordenada baricêntrica de `b`.
+ * @param v Coordenada baricêntrica de `c`.
+ * @param error Recebe o erro absoluto máximo do ponto reconstruído.
+ * @return point3 Ponto no triângulo.
+ */
+inline point3 barycentric_point(const point3& a, const point3& b, const point3& c,
+                                real u, real v, real& error) {
+    const real w = 1 - u - v;
+    real extent = 0;
+    for (int k = 0; k < 3; k++)
+        extent = std::fmax(extent, std::fabs(w * a[k]) + std::fabs(u * b[k]) + std::fabs(v * c[k]));
+    error = 8 * std::numeric_limits<real>::epsilon() * extent;
+    return w * a + u * b + v * c;
+}
+
+#endif
@@ -0,0 +1,341 @@
+/**
+ * @file ray_packet.h
+ * @brief Arquivo de implementação dos pacotes de raios coerentes e dos vetores SIMD de `double`
+ */
+
+#ifndef RAY_PACKET_H
+#define RAY_PACKET_H
+
+#include "./utils.h"
+#include "./aabb.h"
+#include "./simd_dispatch.h"
+
+#include <cstdint>
+
+#if RT_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+class hittable;
+
+/*
+ * Vetores SIMD de `double` usados pelos kernels de pacotes de raios, um por nível de
+ * `simd_level`: sem SIMD (1 posição), SSE2 (2), AVX2 (4) e AVX-512 (8). Todos têm a mesma
+ * interface, então cada kernel é escrito uma vez, como template, e compilado para cada nível
+ * (`run_simd`). Os kernels repetem exatamente as operações das versões escalares, em precisão
+ * dupla e sem FMA, então um raio atinge o mesmo objeto com o mesmo `t` em qualquer nível,
+ * dentro ou fora de um pacote.
+ */
+
+namespace simd_scalar {
+/** @brief Máscara resultante de uma comparação entre `simd_double`. */
+struct simd_mask { bool v; };
+
+/** @brief Vetor de uma posição, usado quando não há SIMD. */
+struct simd_double {
+    static const int width = 1; /**< Quantidade de posições do vetor. */
+    double v;
+
+    simd_double() = default;
+    explicit simd_double(double x) : v(x) {}
+    static simd_double load(const double* p) { return simd_double(*p); }
+    void store(double* p) const { *p = v; }
+};
+
+inline simd_double operator+(simd_double a, simd_double b) { return simd_double(a.v + b.v); }
+inline simd_double operator-(simd_double a, simd_double b) { return simd_double(a.v - b.v); }
+inline simd_double operator*(simd_double a, simd_double b) { return simd_double(a.v * b.v); }
+inline simd_double operator/(simd_double a, simd_double b) { return simd_double(a.v / b.v); }
+inline simd_double operator-(simd_double a) { return simd_double(-a.v); }
+inline simd_double simd_sqrt(simd_double a) { return simd_double(std::sqrt(a.v)); }
+inline simd_double simd_abs(simd_double a) { return simd_double(std::fabs(a.v)); }
+inline simd_mask operator<(simd_double a, simd_double b) { return {a.v < b.v}; }
+inline simd_mask operator>(simd_double a, simd_double b) { return {a.v > b.v}; }
+inline simd_mask operator&(simd_mask a, simd_mask b) { return {a.v && b.v}; }
+inline simd_mask operator|(simd_mask a, simd_mask b) { return {a.v || b.v}; }
+/** @brief Retorna `a & ~b`. */
+inline simd_mask and_not(simd_mask a, simd_mask b) { return {a.v && !b.v}; }
+/** @brief Escolhe `a` nas posições da máscara e `b` nas demais. */
+inline simd_double select(simd_mask m, simd_double a, simd_double b) { return m.v ? a : b; }
+/** @brief Retorna um bit por posição da máscara. */
+inline int lane_bits(simd_mask m) { return m.v ? 1 : 0; }
+}
+
+#if RT_X86_DISPATCH
+namespace simd_sse2 {
+/** @brief Máscara resultante de uma comparação entre `simd_double`. */
+struct simd_mask { __m128d v; };
+
+/** @brief Vetor de 2 posições (SSE2). */
+struct simd_double {
+    static const int width = 2; /**< Quantidade de posições do vetor. */
+    __m128d v;
+
+    simd_double() = default;
+    RT_TARGET("sse2") simd_double(__m128d x) : v(x) {}
+    RT_TARGET("sse2") explicit simd_double(double x) : v(_mm_set1_pd(x)) {}
+    RT_TARGET("sse2") static simd_double load(const double* p) { return _mm_loadu_pd(p); }
+    RT_TARGET("sse2") void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+
+RT_TARGET("sse2") inline simd_double operator+(simd_double a, simd_double b) { return _mm_add_pd(a.v, b.v); }
+RT_TARGET("sse2") inline simd_double operator-(simd_double a, simd_double b) { return _mm_sub_pd(a.v, b.v); }
+RT_TARGET("sse2") inline simd_double operator*(simd_double a, simd_double b) { return _mm_mul_pd(a.v, b.v); }
+RT_TARGET("sse2") inline simd_double operator/(simd_double a, simd_double b) { return _mm_div_pd(a.v, b.v); }
+RT_TARGET("sse2") inline simd_double operator-(simd_double a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+RT_TARGET("sse2") inline simd_double simd_sqrt(simd_double a) { return _mm_sqrt_pd(a.v); }
+RT_TARGET("sse2") inline simd_double simd_abs(simd_double a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+RT_TARGET("sse2") inline simd_mask operator<(simd_double a, simd_double b) { return {_mm_cmplt_pd(a.v, b.v)}; }
+RT_TARGET("sse2") inline simd_mask operator>(simd_double a, simd_double b) { return {_mm_cmpgt_pd(a.v, b.v)}; }
+RT_TARGET("sse2") inline simd_mask operator&(simd_mask a, simd_mask b) { return {_mm_and_pd(a.v, b.v)}; }
+RT_TARGET("sse2") inline simd_mask operator|(simd_mask a, simd_mask b) { return {_mm_or_pd(a.v, b.v)}; }
+/** @brief Retorna `a & ~b`. */
+RT_TARGET("sse2") inline simd_mask and_not(simd_mask a, simd_mask b) { return {_mm_andnot_pd(b.v, a.v)}; }
+/** @brief Escolhe `a` nas posições da máscara e `b` nas demais. */
+RT_TARGET("sse2") inline simd_double select(simd_mask m, simd_double a, simd_double b) {
+    return _mm_or_pd(_mm_and_pd(m.v, a.v), _mm_andnot_pd(m.v, b.v));
+}
+/** @brief Retorna um bit por posição da máscara. */
+RT_TARGET("sse2") inline int lane_bits(simd_mask m) { return _mm_movemask_pd(m.v); }
+}
+
+namespace simd_avx2 {
+/** @brief Máscara resultante de uma comparação entre `simd_double`. */
+struct simd_mask { __m256d v; };
+
+/** @brief Vetor de 4 posições (AVX2). */
+struct simd_double {
+    static const int width = 4; /**< Quantidade de posições do vetor. */
+    __m256d v;
+
+    simd_double() = default;
+    RT_TARGET("avx2") simd_double(__m256d x) : v(x) {}
+    RT_TARGET("avx2") explicit simd_double(double x) : v(_mm256_set1_pd(x)) {}
+    RT_TARGET("avx2") static simd_double load(const double* p) { return _mm256_loadu_pd(p); }
+    RT_TARGET("avx2") void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+
+RT_TARGET("avx2") inline simd_double operator+(simd_double a, simd_double b) { return _mm256_add_pd(a.v, b.v); }
+RT_TARGET("avx2") inline simd_double operator-(simd_double a, simd_double b) { return _mm256_sub_pd(a.v, b.v); }
+RT_TARGET("avx2") inline simd_double operator*(simd_double a, simd_double b) { return _mm256_mul_pd(a.v, b.v); }
+RT_TARGET("avx2") inline simd_double operator/(simd_double a, simd_double b) { return _mm256_div_pd(a.v, b.v); }
+RT_TARGET("avx2") inline simd_double operator-(simd_double a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+RT_TARGET("avx2") inline simd_double simd_sqrt(simd_double a) { return _mm256_sqrt_pd(a.v); }
+RT_TARGET("avx2") inline simd_double simd_abs(simd_double a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+RT_TARGET("avx2") inline simd_mask operator<(simd_double a, simd_double b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+RT_TARGET("avx2") inline simd_mask operator>(simd_double a, simd_double b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+RT_TARGET("avx2") inline simd_mask operator&(simd_mask a, simd_mask b) { return {_mm256_and_pd(a.v, b.v)}; }
+RT_TARGET("avx2") inline simd_mask operator|(simd_mask a, simd_mask b) { return {_mm256_or_pd(a.v, b.v)}; }
+/** @brief Retorna `a & ~b`. */
+RT_TARGET("avx2") inline simd_mask and_not(simd_mask a, simd_mask b) { return {_mm256_andnot_pd(b.v, a.v)}; }
+/** @brief Escolhe `a` nas posições da máscara e `b` nas demais. */
+RT_TARGET("avx2") inline simd_double select(simd_mask m, simd_double a, simd_double b) { return _mm256_blendv_pd(b.v, a.v, m.v); }
+/** @brief Retorna um bit por posição da máscara. */
+RT_TARGET("avx2") inline int lane_bits(simd_mask m) { return _mm256_movemask_pd(m.v); }
+}
+
+namespace simd_avx512 {
+/** @brief Máscara resultante de uma comparação entre `simd_double` (um bit por posição). */
+struct simd_mask { __mmask8 v; };
+
+/** @brief Vetor de 8 posições (AVX-512F). */
+struct simd_double {
+    static const int width = 8; /**< Quantidade de posições do vetor. */
+    __m512d v;
+
+    simd_double() = default;
+    RT_TARGET("avx512f") simd_double(__m512d x) : v(x) {}
+    RT_TARGET("avx512f") explicit simd_double(double x) : v(_mm512_set1_pd(x)) {}
+    RT_TARGET("avx512f") static simd_double load(const double* p) { return _mm512_loadu_pd(p); }
+    RT_TARGET("avx512f") void store(double* p) const { _mm512_storeu_pd(p, v); }
+};
+
+RT_TARGET("avx512f") inline simd_double operator+(simd_double a, simd_double b) { return _mm512_add_pd(a.v, b.v); }
+RT_TARGET("avx512f") inline simd_double operator-(simd_double a, simd_double b) { return _mm512_sub_pd(a.v, b.v); }
+RT_TARGET("avx512f") inline simd_double operator*(simd_double a, simd_double b) { return _mm512_mul_pd(a.v, b.v); }
+RT_TARGET("avx512f") inline simd_double operator/(simd_double a, simd_double b) { return _mm512_div_pd(a.v, b.v); }
+RT_TARGET("avx512f") inline simd_double operator-(simd_double a) {
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.v), _mm512_set1_epi64(INT64_MIN)));
+}
+// A forma com máscara evita um falso aviso de variável não inicializada do GCC em `_mm512_sqrt_pd`.
+RT_TARGET("avx512f") inline simd_double simd_sqrt(simd_double a) { return _mm512_maskz_sqrt_pd(0xFF, a.v); }
+RT_TARGET("avx512f") inline simd_double simd_abs(simd_double a) { return _mm512_abs_pd(a.v); }
+RT_TARGET("avx512f") inline simd_mask operator<(simd_double a, simd_double b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)}; }
+RT_TARGET("avx512f") inline simd_mask operator>(simd_double a, simd_double b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)}; }
+inline simd_mask operator&(simd_mask a, simd_mask b) { return {static_cast<__mmask8>(a.v & b.v)}; }
+inline simd_mask operator|(simd_mask a, simd_mask b) { return {static_cast<__mmask8>(a.v | b.v)}; }
+/** @brief Retorna `a & ~b`. */
+inline simd_mask and_not(simd_mask a, simd_mask b) { return {static_cast<__mmask8>(a.v & ~b.v)}; }
+/** @brief Escolhe `a` nas posições da máscara e `b` nas demais. */
+RT_TARGET("avx512f") inline simd_double select(simd_mask m, simd_double a, simd_double b) { return _mm512_mask_blend_pd(m.v, b.v, a.v); }
+/** @brief Retorna um bit por posição da máscara. */
+inline int lane_bits(simd_mask m) { return m.v; }
+}
+#endif
+
+/**
+ * @brief Identifica, em um kernel genérico, o vetor SIMD de um nível.
+ */
+template <typename V>
+struct simd_tag { using type = V; };
+
+#if RT_X86_DISPATCH
+template <typename Kernel>
+RT_TARGET("sse2") void run_simd_sse2(Kernel& kernel) { kernel(simd_tag<simd_sse2::simd_double>()); }
+
+template <typename Kernel>
+RT_TARGET("avx2") void run_simd_avx2(Kernel& kernel) { kernel(simd_tag<simd_avx2::simd_double>()); }
+
+template <typename Kernel>
+RT_TARGET("avx512f") void run_simd_avx512(Kernel& kernel) { kernel(simd_tag<simd_avx512::simd_double>()); }
+#endif
+
+/**
+ * @brief Executa um kernel genérico com o vetor SIMD mais largo do nível ativo que divide `N`.
+ *
+ * O kernel recebe um `simd_tag<V>` e deve ser marcado com `RT_ALWAYS_INLINE`, para que seja
+ * expandido dentro da versão compilada para o nível (AVX-512 só é usado quando `N` é múltiplo de 8).
+ *
+ * @tparam N Quantidade de raios processados pelo kernel.
+ * @param kernel Kernel genérico.
+ */
+template <int N, typename Kernel>
+inline void run_simd(Kernel&& kernel) {
+#if RT_X86_DISPATCH
+    switch (active_simd_level()) {
+        case simd_level::avx512:
+            if constexpr (N % 8 == 0) {
+                run_simd_avx512(kernel);
+                return;
+            }
+            [[fallthrough]];
+        case simd_level::avx2:
+            if constexpr (N % 4 == 0) {
+                run_simd_avx2(kernel);
+                return;
+            }
+            [[fallthrough]];
+        case simd_level::sse42:
+        case simd_level::sse2:
+            if constexpr (N % 2 == 0) {
+                run_simd_sse2(kernel);
+                return;
+            }
+            [[fallthrough]];
+        default:
+            break;
+    }
+#endif
+    kernel(simd_tag<simd_scalar::simd_double>());
+}
+
+/**
+ * @brief Pacote de `N` raios com a mesma origem aproximada, em estrutura de vetores (SoA).
+ *
+ * Usado para os raios primários de pixels vizinhos, que percorrem a cena quase juntos.
+ * Cada posição guarda o seu raio, o seu limite `tmax` (reduzido a cada interseção) e a
+ * interseção mais próxima encontrada. Uma posição com `tmax <= tmin` está inativa e nunca é atingida.
+ *
+ * @tparam N Quantidade de raios.
+ */
+template <int N>
+struct ray_packet {
+    static const int size = N; /**< Quantidade de raios do pacote. */
+
+    double ox[N], oy[N], oz[N];             /**< Origens dos raios. */
+    double dx[N], dy[N], dz[N];             /**< Direções dos raios. */
+    double inv_dx[N], inv_dy[N], inv_dz[N]; /**< Inversos das componentes das direções. */
+    double tmin = 0;                        /**< Início do intervalo válido, comum a todos os raios. */
+    double tmax[N];                         /**< Fim do intervalo válido de cada raio. */
+
+    const hittable* object[N]; /**< Primitiva atingida (nullptr se nenhuma). */
+    uint32_t prim[N];          /**< Triângulo atingido dentro da primitiva. */
+    float u[N], v[N];          /**< Coordenadas baricêntricas da interseção. */
+
+    /**
+     * @brief Armazena um raio em uma posição do pacote e limpa a sua interseção.
+     *
+     * @param lane Posição no pacote.
+     * @param r Raio.
+     * @param t_max Fim do intervalo válido.
+     */
+    void set(int lane, const ray& r, double t_max = infinity) {
+        const point3 o = r.origin();
+        const vec3 d = r.direction();
+        ox[lane] = o.x(); oy[lane] = o.y(); oz[lane] = o.z();
+        dx[lane] = d.x(); dy[lane] = d.y(); dz[lane] = d.z();
+        inv_dx[lane] = 1 / d.x(); inv_dy[lane] = 1 / d.y(); inv_dz[lane] = 1 / d.z();
+        tmax[lane] = t_max;
+        object[lane] = nullptr;
+        prim[lane] = 0;
+        u[lane] = v[lane] = 0;
+    }
+
+    /**
+     * @brief Desativa uma posição do pacote (por exemplo, além da borda da imagem).
+     */
+    void disable(int lane) {
+        set(lane, ray(point3(0,0,0), vec3(0,0,1)), tmin);
+    }
+
+    /**
+     * @brief Retorna o raio de uma posição.
+     */
+    ray get_ray(int lane) const {
+        return ray(point3(ox[lane], oy[lane], oz[lane]), vec3(dx[lane], dy[lane], dz[lane]));
+    }
+
+    /**
+     * @brief Indica se a posição pode ser atingida.
+     */
+    bool active(int lane) const { return tmin < tmax[lane]; }
+
+    /**
+     * @brief Registra uma interseção mais próxima em uma posição, reduzindo o seu `tmax`.
+     */
+    void record(int lane, double t, const hittable* obj, uint32_t primitive, float hit_u, float hit_v) {
+        tmax[lane] = t;
+        object[lane] = obj;
+        prim[lane] = primitive;
+        u[lane] = hit_u;
+        v[lane] = hit_v;
+    }
+
+    /**
+     * @brief Verifica se algum raio do pacote atravessa uma caixa, com o mesmo teste de `aabb::hit`.
+     *
+     * @tparam V Vetor SIMD usado (ver `run_simd`).
+     * @param box Caixa delimitadora.
+     * @return true Se ao menos uma posição atinge a caixa dentro do seu intervalo.
+     */
+    template <typename V>
+    RT_ALWAYS_INLINE inline bool hits_box(const aabb& box) const {
+        const V zero(0.0);
+        const double* origins[3] = {ox, oy, oz};
+        const double* inverses[3] = {inv_dx, inv_dy, inv_dz};
+
+        for (int k = 0; k < N; k += V::width) {
+            V t_min(tmin);
+            V t_max = V::load(tmax + k);
+            for (int a = 0; a < 3; a++) {
+                const V inv = V::load(inverses[a] + k);
+                const V orig = V::load(origins[a] + k);
+                const V t0 = (V(box.axis(a).min) - orig) * inv;
+                const V t1 = (V(box.axis(a).max) - orig) * inv;
+                const auto negative = inv < zero;
+                const V near = select(negative, t1, t0);
+                const V far = select(negative, t0, t1);
+                t_min = select(near > t_min, near, t_min);
+                t_max = select(far < t_max, far, t_max);
+            }
+            if (lane_bits(t_max > t_min))
+                return true;
+        }
+        return false;
+    }
+};
+
+using ray_packet4 = ray_packet<4>; /**< Pacote de 4 raios. */
+using ray_packet8 = ray_packet<8>; /**< Pacote de 8 raios. */
+
+#endif
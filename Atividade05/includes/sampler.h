@@ -0,0 +1,367 @@
+/**
+ * @file sampler.h
+ * @brief Arquivo de implementação dos amostradores (independente, estratificado, Sobol e ruído azul)
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "./utils.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Interface de um amostrador de números em [0, 1).
+ *
+ * Cada valor é identificado pelo pixel, pela amostra do pixel e pela dimensão (jitter do pixel,
+ * lente, direção de cada rebatimento, ...). Os amostradores não guardam estado entre chamadas,
+ * então uma mesma instância pode ser usada por todas as threads da renderização.
+ */
+class sampler {
+  public:
+    virtual ~sampler() = default;
+
+    /**
+     * @brief Retorna o valor de uma dimensão de uma amostra.
+     *
+     * @param x Coluna do pixel.
+     * @param y Linha do pixel.
+     * @param sample Índice da amostra do pixel.
+     * @param dimension Dimensão da amostra.
+     * @return double Valor em [0, 1).
+     */
+    virtual double get(int x, int y, int sample, int dimension) const = 0;
+};
+
+/**
+ * @brief Sequência de dimensões de uma amostra, consumida pela câmera e pelos materiais.
+ */
+struct sample_stream {
+    const sampler* source; /**< Amostrador usado. */
+    int x, y;              /**< Pixel da amostra. */
+    int sample;            /**< Índice da amostra do pixel. */
+    int dimension;         /**< Próxima dimensão a ser consumida. */
+
+    /**
+     * @brief Retorna o valor da próxima dimensão.
+     *
+     * @return double Valor em [0, 1).
+     */
+    double next() { return source->get(x, y, sample, dimension++); }
+};
+
+/**
+ * @brief Converte os 32 bits superiores de um inteiro para um double em [0, 1).
+ */
+inline double bits_to_unit(uint32_t bits) {
+    return bits * (1.0 / 4294967296.0);
+}
+
+/**
+ * @brief Combina coordenadas inteiras em uma semente de 32 bits.
+ */
+inline uint32_t sampler_hash(uint64_t a, uint64_t b = 0, uint64_t c = 0) {
+    return static_cast<uint32_t>(mix_bits(mix_bits(mix_bits(a) ^ b) ^ c) >> 32);
+}
+
+/**
+ * @brief Amostrador independente: cada dimensão é um número aleatório uniforme.
+ *
+ * Usa o gerador da thread (`random_double`), que a câmera reinicia por pixel, amostra e rebatimento.
+ */
+class independent_sampler : public sampler {
+  public:
+    double get(int, int, int, int) const override { return random_double(); }
+};
+
+/**
+ * @brief Amostrador estratificado (hipercubo latino).
+ *
+ * Em cada dimensão, as `samples_per_pixel` amostras de um pixel caem em estratos diferentes do
+ * intervalo [0, 1), com a ordem dos estratos embaralhada por pixel e por dimensão. A estratificação
+ * vale para o conjunto completo de amostras, então o número de amostras precisa ser conhecido.
+ */
+class stratified_sampler : public sampler {
+  public:
+    /**
+     * @brief Construtor da classe Stratified_sampler.
+     *
+     * @param samples_per_pixel Quantidade de amostras de cada pixel.
+     */
+    stratified_sampler(int samples_per_pixel) : strata(samples_per_pixel > 0 ? samples_per_pixel : 1) {}
+
+    double get(int x, int y, int sample, int dimension) const override {
+        uint32_t seed = sampler_hash(static_cast<uint64_t>(y) << 32 | static_cast<uint32_t>(x), dimension);
+        uint32_t stratum = permute(static_cast<uint32_t>(sample) % strata, strata, seed);
+        double jitter = bits_to_unit(sampler_hash(seed, sample, 0x5bd1e995u));
+        return (stratum + jitter) / strata;
+    }
+
+  private:
+    uint32_t strata; /**< Quantidade de estratos por dimensão. */
+
+    /**
+     * @brief Permutação pseudoaleatória de [0, l) sem tabela (Kensler, 2013).
+     */
+    static uint32_t permute(uint32_t i, uint32_t l, uint32_t p) {
+        uint32_t w = l - 1;
+        w |= w >> 1;
+        w |= w >> 2;
+        w |= w >> 4;
+        w |= w >> 8;
+        w |= w >> 16;
+        do {
+            i ^= p;             i *= 0xe170893du;
+            i ^= p >> 16;
+            i ^= (i & w) >> 4;
+            i ^= p >> 8;        i *= 0x0929eb3fu;
+            i ^= p >> 23;
+            i ^= (i & w) >> 1;  i *= 1 | p >> 27;
+                                i *= 0x6935fa69u;
+            i ^= (i & w) >> 11; i *= 0x74dcb303u;
+            i ^= (i & w) >> 2;  i *= 0x9e501cc3u;
+            i ^= (i & w) >> 2;  i *= 0xc860a3dfu;
+            i &= w;
+            i ^= i >> 5;
+        } while (i >= l);
+        return (i + p) % l;
+    }
+};
+
+/**
+ * @brief Inverte a ordem dos bits de um inteiro de 32 bits.
+ */
+inline uint32_t reverse_bits(uint32_t v) {
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0F0F0F0Fu) | ((v & 0x0F0F0F0Fu) << 4);
+    v = ((v >> 8) & 0x00FF00FFu) | ((v & 0x00FF00FFu) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+/**
+ * @brief Embaralhamento de Owen de um valor de 32 bits, baseado em hash (Burley, 2020).
+ *
+ * @param v Valor a ser embaralhado.
+ * @param seed Semente do embaralhamento.
+ * @return uint32_t Valor embaralhado.
+ */
+inline uint32_t nested_uniform_scramble(uint32_t v, uint32_t seed) {
+    v = reverse_bits(v);
+    v += seed;
+    v ^= v * 0x6c50b47cu;
+    v ^= v * 0xb82f1e52u;
+    v ^= v * 0xc7afe638u;
+    v ^= v * 0x8d22f6e6u;
+    return reverse_bits(v);
+}
+
+/**
+ * @brief Retorna um ponto das 4 primeiras dimensões da sequência de Sobol.
+ *
+ * Os números de direção vêm dos polinômios primitivos de Joe e Kuo para as dimensões 2 a 4;
+ * a primeira dimensão é a sequência de van der Corput.
+ *
+ * @param index Índice do ponto.
+ * @param dimension Dimensão (0 a 3).
+ * @return uint32_t Coordenada do ponto em ponto fixo (32 bits fracionários).
+ */
+inline uint32_t sobol(uint32_t index, int dimension) {
+    struct direction_table {
+        uint32_t v[4][32];
+
+        direction_table() {
+            for (int k = 0; k < 32; k++)
+                v[0][k] = 1u << (31 - k);
+
+            v[1][0] = 1u << 31;
+            for (int k = 1; k < 32; k++)
+                v[1][k] = v[1][k-1] ^ (v[1][k-1] >> 1);
+
+            v[2][0] = 1u << 31;
+            v[2][1] = 3u << 30;
+            for (int k = 2; k < 32; k++)
+                v[2][k] = v[2][k-2] ^ (v[2][k-2] >> 2) ^ v[2][k-1];
+
+            v[3][0] = 1u << 31;
+            v[3][1] = 3u << 30;
+            v[3][2] = 1u << 29;
+            for (int k = 3; k < 32; k++)
+                v[3][k] = v[3][k-3] ^ (v[3][k-3] >> 3) ^ v[3][k-2];
+        }
+    };
+    static const direction_table directions;
+
+    uint32_t result = 0;
+    for (int k = 0; index; index >>= 1, k++) {
+        if (index & 1)
+            result ^= directions.v[dimension][k];
+    }
+    return result;
+}
+
+/**
+ * @brief Ponto da sequência de Sobol embaralhada (Owen) e reordenada por hash.
+ *
+ * As dimensões são agrupadas de 4 em 4; cada grupo usa as 4 primeiras dimensões de Sobol com
+ * uma semente própria, o que evita correlação entre grupos sem precisar de dimensões altas.
+ *
+ * @param sample Índice da amostra.
+ * @param dimension Dimensão da amostra.
+ * @param seed Semente (por pixel, ou global).
+ * @return uint32_t Coordenada do ponto em ponto fixo.
+ */
+inline uint32_t scrambled_sobol(uint32_t sample, int dimension, uint32_t seed) {
+    uint32_t group_seed = sampler_hash(seed, static_cast<uint32_t>(dimension / 4));
+    uint32_t index = nested_uniform_scramble(sample, group_seed);
+    int d = dimension % 4;
+    return nested_uniform_scramble(sobol(index, d), sampler_hash(group_seed, d));
+}
+
+/**
+ * @brief Amostrador de Sobol embaralhado, com sementes independentes por pixel.
+ *
+ * Qualquer prefixo de `2^k` amostras é bem estratificado, então o amostrador também funciona com
+ * a amostragem adaptativa.
+ */
+class sobol_sampler : public sampler {
+  public:
+    /**
+     * @brief Construtor da classe Sobol_sampler.
+     *
+     * @param _seed Semente do embaralhamento; sementes diferentes geram sequências independentes.
+     */
+    sobol_sampler(uint32_t _seed = 0) : seed(_seed) {}
+
+    double get(int x, int y, int sample, int dimension) const override {
+        uint32_t pixel_seed = sampler_hash(static_cast<uint64_t>(y) << 32 | static_cast<uint32_t>(x), seed);
+        return bits_to_unit(scrambled_sobol(static_cast<uint32_t>(sample), dimension, pixel_seed));
+    }
+
+  private:
+    uint32_t seed; /**< Semente do embaralhamento. */
+};
+
+/**
+ * @brief Amostrador de ruído azul (Georgiev e Fajardo, 2016).
+ *
+ * Todos os pixels usam a mesma sequência de Sobol embaralhada, deslocada (rotação de
+ * Cranley–Patterson) pelo valor de uma máscara de ruído azul de 64 x 64 pixels. O erro de pixels
+ * vizinhos fica descorrelacionado e concentrado em altas frequências, o que o torna menos visível
+ * com poucas amostras. Cada dimensão usa uma posição diferente da máscara.
+ */
+class blue_noise_sampler : public sampler {
+  public:
+    double get(int x, int y, int sample, int dimension) const override {
+        static const std::vector<float> mask = blue_noise_mask();
+
+        uint32_t shift = sampler_hash(static_cast<uint32_t>(dimension), 0x9e3779b9u);
+        int mx = (x + static_cast<int>(shift & (mask_size - 1))) & (mask_size - 1);
+        int my = (y + static_cast<int>((shift >> 8) & (mask_size - 1))) & (mask_size - 1);
+
+        double value = bits_to_unit(scrambled_sobol(static_cast<uint32_t>(sample), dimension, 0))
+                     + mask[my * mask_size + mx];
+        return value < 1.0 ? value : value - 1.0;
+    }
+
+  private:
+    static const int mask_size = 64; /**< Lado da máscara de ruído azul. */
+
+    /**
+     * @brief Gera a máscara de ruído azul pelo método void-and-cluster (Ulichney, 1993).
+     *
+     * Cada pixel recebe a ordem em que entra no padrão binário; pixels com ordens próximas ficam
+     * afastados entre si. Executado uma única vez, no primeiro uso.
+     *
+     * @return std::vector<float> Valores da máscara em [0, 1), em ordem de linhas.
+     */
+    static std::vector<float> blue_noise_mask() {
+        const int n = mask_size * mask_size;
+        const double sigma = 1.5;
+
+        // Energia de cada pixel: soma de gaussianas (com distância toroidal) dos pixels ativos.
+        std::vector<double> kernel(n);
+        for (int dy = 0; dy < mask_size; dy++) {
+            for (int dx = 0; dx < mask_size; dx++) {
+                int ddx = dx < mask_size / 2 ? dx : dx - mask_size;
+                int ddy = dy < mask_size / 2 ? dy : dy - mask_size;
+                kernel[dy * mask_size + dx] = exp(-(ddx*ddx + ddy*ddy) / (2 * sigma * sigma));
+            }
+        }
+
+        std::vector<char> pattern(n, 0);
+        std::vector<double> energy(n, 0.0);
+        auto toggle = [&](int p, bool on) {
+            pattern[p] = on;
+            int px = p % mask_size, py = p / mask_size;
+            double sign = on ? 1.0 : -1.0;
+            for (int q = 0; q < n; q++) {
+                int dx = (q % mask_size - px) & (mask_size - 1);
+                int dy = (q / mask_size - py) & (mask_size - 1);
+                energy[q] += sign * kernel[dy * mask_size + dx];
+            }
+        };
+        auto tightest_cluster = [&](const std::vector<char>& p) {
+            int best = -1;
+            for (int q = 0; q < n; q++)
+                if (p[q] && (best < 0 || energy[q] > energy[best]))
+                    best = q;
+            return best;
+        };
+        auto largest_void = [&](const std::vector<char>& p) {
+            int best = -1;
+            for (int q = 0; q < n; q++)
+                if (!p[q] && (best < 0 || energy[q] < energy[best]))
+                    best = q;
+            return best;
+        };
+
+        // Padrão inicial: 10% dos pixels, redistribuídos até não haver mais aglomerados.
+        pcg32 generator;
+        generator.seed(0x853c49e6748fea9bULL, 7);
+        int ones = n / 10;
+        for (int placed = 0; placed < ones; ) {
+            int p = static_cast<int>(generator.next() % n);
+            if (!pattern[p]) {
+                toggle(p, true);
+                placed++;
+            }
+        }
+        while (true) {
+            int cluster = tightest_cluster(pattern);
+            toggle(cluster, false);
+            int hole = largest_void(pattern);
+            toggle(hole, true);
+            if (hole == cluster)
+                break;
+        }
+
+        std::vector<int> rank(n, 0);
+        const std::vector<char> initial = pattern;
+        const std::vector<double> initial_energy = energy;
+
+        // Fase 1: remove os aglomerados do padrão inicial, das ordens maiores para as menores.
+        for (int r = ones - 1; r >= 0; r--) {
+            int cluster = tightest_cluster(pattern);
+            toggle(cluster, false);
+            rank[cluster] = r;
+        }
+
+        // Fase 2: a partir do padrão inicial, preenche os maiores vazios até completar a máscara.
+        pattern = initial;
+        energy = initial_energy;
+        for (int r = ones; r < n; r++) {
+            int hole = largest_void(pattern);
+            toggle(hole, true);
+            rank[hole] = r;
+        }
+
+        std::vector<float> mask(n);
+        for (int p = 0; p < n; p++)
+            mask[p] = (rank[p] + 0.5f) / n;
+        return mask;
+    }
+};
+
+#endif
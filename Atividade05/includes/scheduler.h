@@ -0,0 +1,134 @@
+/**
+ * @file scheduler.h
+ * @brief Arquivo de implementação do escalonador de tarefas com roubo de trabalho
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fila de tarefas de uma thread trabalhadora.
+ *
+ * A dona da fila consome tarefas pelo final (`pop`), enquanto as demais threads roubam
+ * tarefas pelo início (`steal`), o que mantém blocos vizinhos na mesma thread.
+ */
+class work_queue {
+  public:
+    /**
+     * @brief Adiciona uma tarefa ao final da fila.
+     *
+     * @param task Índice da tarefa.
+     */
+    void push(int task) {
+        std::lock_guard<std::mutex> guard(lock);
+        tasks.push_back(task);
+    }
+
+    /**
+     * @brief Retira uma tarefa do final da fila (usado pela thread dona).
+     *
+     * @param task Tarefa retirada.
+     * @return true Se havia alguma tarefa.
+     * @return false Se a fila estava vazia.
+     */
+    bool pop(int& task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty())
+            return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Rouba uma tarefa do início da fila (usado pelas outras threads).
+     *
+     * @param task Tarefa roubada.
+     * @return true Se havia alguma tarefa.
+     * @return false Se a fila estava vazia.
+     */
+    bool steal(int& task) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty())
+            return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+
+  private:
+    std::deque<int> tasks; /**< Tarefas pendentes. */
+    std::mutex lock;       /**< Protege o acesso à fila. */
+};
+
+/**
+ * @brief Executa `task_count` tarefas independentes em um conjunto de threads com roubo de trabalho.
+ *
+ * As tarefas são divididas em faixas contíguas, uma por thread. Quando a fila de uma thread
+ * esvazia, ela passa a roubar tarefas das demais, equilibrando blocos caros (vidro, malhas)
+ * com blocos baratos (céu).
+ *
+ * @param task_count Quantidade de tarefas.
+ * @param thread_count Quantidade de threads (0 usa o número de núcleos disponíveis).
+ * @param body Função executada para cada tarefa, recebendo o índice da tarefa e da thread.
+ */
+inline void parallel_for_tasks(int task_count, int thread_count, const std::function<void(int, int)>& body) {
+    if (thread_count <= 0)
+        thread_count = static_cast<int>(std::thread::hardware_concurrency());
+    if (thread_count <= 0)
+        thread_count = 1;
+    if (thread_count > task_count)
+        thread_count = task_count > 0 ? task_count : 1;
+
+    if (thread_count == 1) {
+        for (int task = 0; task < task_count; task++)
+            body(task, 0);
+        return;
+    }
+
+    std::vector<work_queue> queues(thread_count);
+    for (int worker = 0; worker < thread_count; worker++) {
+        int begin = static_cast<int>(static_cast<long long>(task_count) * worker / thread_count);
+        int end = static_cast<int>(static_cast<long long>(task_count) * (worker + 1) / thread_count);
+        // Empilhadas em ordem reversa para que `pop` devolva as tarefas em ordem crescente.
+        for (int task = end - 1; task >= begin; task--)
+            queues[worker].push(task);
+    }
+
+    // Como nenhuma tarefa gera novas tarefas, uma thread pode encerrar assim que
+    // não encontrar trabalho em nenhuma fila.
+    auto worker_loop = [&](int worker) {
+        int task;
+        while (true) {
+            if (queues[worker].pop(task)) {
+                body(task, worker);
+                continue;
+            }
+
+            bool stolen = false;
+            for (int offset = 1; offset < thread_count && !stolen; offset++) {
+                int victim = (worker + offset) % thread_count;
+                stolen = queues[victim].steal(task);
+            }
+            if (!stolen)
+                return;
+            body(task, worker);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int worker = 1; worker < thread_count; worker++)
+        workers.emplace_back(worker_loop, worker);
+    worker_loop(0);
+
+    for (auto& t : workers)
+        t.join();
+}
+
+#endif
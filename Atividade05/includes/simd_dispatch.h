@@ -0,0 +1,151 @@
+/**
+ * @file simd_dispatch.h
+ * @brief Arquivo de implementação da seleção, em tempo de execução, do conjunto de instruções SIMD
+ */
+
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Níveis de instruções SIMD para os quais os kernels são compilados.
+ *
+ * Os kernels de interseção (blocos de triângulos e pacotes de raios) e a conversão do buffer HDR
+ * são compilados para cada nível no mesmo binário, com atributos `target`, e o mais largo
+ * suportado pela CPU é escolhido uma única vez, na inicialização.
+ */
+enum class simd_level {
+    scalar = 0, /**< Sem SIMD. */
+    sse2,       /**< SSE2 (mínimo em x86-64). */
+    sse42,      /**< SSE4.2; usa os kernels de SSE2. */
+    avx2,       /**< AVX2. */
+    avx512      /**< AVX-512F. */
+};
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RT_X86_DISPATCH 1
+/** @brief Compila a função para um conjunto de instruções específico (por exemplo, "avx2"). */
+#define RT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RT_X86_DISPATCH 0
+#define RT_TARGET(isa)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/** @brief Força a expansão de um kernel genérico dentro da versão específica de cada nível. */
+#define RT_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define RT_ALWAYS_INLINE
+#endif
+
+/**
+ * @brief Retorna o nome de um nível, como aceito pela variável de ambiente `RT_SIMD`.
+ *
+ * @param level Nível SIMD.
+ * @return const char* Nome do nível.
+ */
+inline const char* simd_level_name(simd_level level) {
+    switch (level) {
+        case simd_level::sse2:   return "sse2";
+        case simd_level::sse42:  return "sse4.2";
+        case simd_level::avx2:   return "avx2";
+        case simd_level::avx512: return "avx512";
+        default:                 return "scalar";
+    }
+}
+
+/**
+ * @brief Consulta a CPU (cpuid) e retorna o nível mais largo suportado.
+ *
+ * @return simd_level Nível suportado pela CPU e pelo sistema operacional.
+ */
+inline simd_level detect_simd_level() {
+#if RT_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return simd_level::sse42;
+    if (__builtin_cpu_supports("sse2"))
+        return simd_level::sse2;
+#endif
+    return simd_level::scalar;
+}
+
+/**
+ * @brief Converte um nome de nível (`scalar`, `sse2`, `sse4.2`, `avx2` ou `avx512`).
+ *
+ * @param name Nome do nível.
+ * @param level Nível correspondente.
+ * @return true Se o nome é válido.
+ */
+inline bool parse_simd_level(const char* name, simd_level& level) {
+    for (simd_level candidate : {simd_level::scalar, simd_level::sse2, simd_level::sse42,
+                                 simd_level::avx2, simd_level::avx512}) {
+        if (std::strcmp(name, simd_level_name(candidate)) == 0) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Limita um nível ao suportado pela CPU.
+ *
+ * @param requested Nível desejado.
+ * @return simd_level O menor entre o nível desejado e o suportado.
+ */
+inline simd_level supported_simd_level(simd_level requested) {
+    static const simd_level detected = detect_simd_level();
+    return requested < detected ? requested : detected;
+}
+
+/**
+ * @brief Escolhe o nível inicial: o detectado ou o forçado pela variável de ambiente `RT_SIMD`.
+ *
+ * Um nível acima do suportado pela CPU é reduzido ao suportado, com um aviso.
+ *
+ * @return simd_level Nível usado pelos kernels.
+ */
+inline simd_level initial_simd_level() {
+    simd_level level = supported_simd_level(simd_level::avx512);
+    const char* forced = std::getenv("RT_SIMD");
+    if (forced == nullptr || *forced == '\0')
+        return level;
+
+    simd_level requested;
+    if (!parse_simd_level(forced, requested)) {
+        std::cerr << "RT_SIMD: nível desconhecido '" << forced << "', usando " << simd_level_name(level) << std::endl;
+        return level;
+    }
+    if (supported_simd_level(requested) != requested)
+        std::cerr << "RT_SIMD: " << forced << " não suportado pela CPU, usando " << simd_level_name(level) << std::endl;
+    return supported_simd_level(requested);
+}
+
+/** Nível SIMD usado pelos kernels, escolhido na inicialização do programa. */
+inline simd_level simd_active_level = initial_simd_level();
+
+/**
+ * @brief Retorna o nível SIMD usado pelos kernels.
+ */
+inline simd_level active_simd_level() { return simd_active_level; }
+
+/**
+ * @brief Troca o nível SIMD usado pelos kernels (por exemplo, para compará-los em um benchmark).
+ *
+ * @param level Nível desejado; é limitado ao suportado pela CPU.
+ * @return simd_level Nível efetivamente usado.
+ */
+inline simd_level force_simd_level(simd_level level) {
+    simd_active_level = supported_simd_level(level);
+    return simd_active_level;
+}
+
+#endif
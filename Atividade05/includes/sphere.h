@@ -9,6 +9,9 @@
 #include "utils.h"
 #include "hittable.h"
 
+#include <algorithm>
+#include <limits>
+
 /**
  * @brief Representação de uma esfera no espaço tridimensional.
  * 
@@ -23,19 +26,27 @@ class sphere : public hittable {
      * @param _radius Raio da esfera.
      * @param _material Material associado à esfera.
      */
-    sphere(point3 _center, double _radius, shared_ptr<material> _material)
-      : center(_center), radius(_radius), mat(_material) {}
+    sphere(point3 _center, real _radius, material_id _material)
+      : center(_center), radius(_radius), mat(_material)
+    {
+        auto rvec = vec3(radius, radius, radius);
+        bbox = aabb(center - rvec, center + rvec);
+
+        // O ponto reprojetado em `shade` tem erro proporcional às magnitudes do centro e do raio.
+        real extent = radius + std::max(std::fabs(center.x()), std::max(std::fabs(center.y()), std::fabs(center.z())));
+        p_error = 8 * std::numeric_limits<real>::epsilon() * extent;
+    }
 
     /**
-     * @brief Verifica se um raio atinge a esfera e retorna informações sobre a interseção.
+     * @brief Verifica se um raio intersecta a esfera.
      * 
      * @param r Raio a ser verificado.
      * @param ray_t Dados auxiliares de intervalo do raio.
-     * @param rec Estrutura para armazenamento de informações sobre a interseção.
+     * @param h Estrutura para armazenamento da interseção.
      * @return true Se houve interseção entre o raio e a esfera.
      * @return false Se não houve interseção entre o raio e a esfera.
      */
-    bool hit(const ray& r, interval ray_t, hit_record& rec) const noexcept override {
+    bool intersect(const ray& r, interval ray_t, surface_hit& h) const noexcept override {
         vec3 oc = r.origin() - center;
         auto a = r.direction().length_squared();
         auto half_b = dot(oc, r.direction());
@@ -53,19 +64,131 @@ class sphere : public hittable {
                 return false;
         }
 
-        rec.t = root;
-        rec.p = r.at(rec.t);
+        h.t = root;
+        h.object = this;
+        h.prim = 0;
+        return true;
+    }
+
+    /**
+     * @brief Verifica se o raio atinge a esfera em algum ponto de `ray_t`.
+     * 
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio.
+     * @return true Se alguma das raízes está dentro do segmento.
+     */
+    bool any_hit(const ray& r, interval ray_t) const override {
+        occlusion_counters().primitives++;
+        vec3 oc = r.origin() - center;
+        auto a = r.direction().length_squared();
+        auto half_b = dot(oc, r.direction());
+        auto c = oc.length_squared() - radius*radius;
+
+        auto discriminant = half_b*half_b - a*c;
+        if (discriminant < 0)
+            return false;
+
+        auto sqrtd = sqrt(discriminant);
+        return ray_t.surrounds((-half_b - sqrtd) / a) || ray_t.surrounds((-half_b + sqrtd) / a);
+    }
+
+    /**
+     * @brief Verifica a interseção de um pacote de raios com a esfera (SIMD).
+     * 
+     * @param packet Pacote de raios.
+     */
+    void intersect_packet(ray_packet4& packet) const override { intersect_simd(packet); }
+    void intersect_packet(ray_packet8& packet) const override { intersect_simd(packet); }
+
+    /**
+     * @brief Calcula o ponto, a normal e o material da interseção com a esfera.
+     * 
+     * @param r Raio incidente.
+     * @param h Interseção retornada por `intersect`.
+     * @param rec Estrutura para armazenamento de informações sobre a interseção.
+     */
+    void shade(const ray& r, const surface_hit& h, hit_record& rec) const override {
+        rec.t = h.t;
+        // Reprojeta o ponto na superfície: o erro de `t` cresce com o raio da esfera (no chão de
+        // raio 1000, em float, passa do deslocamento de `spawn_ray`).
+        vec3 offset = r.at(rec.t) - center;
+        rec.p = center + offset * (radius / offset.length());
+        rec.p_error = p_error;
         vec3 outward_normal = (rec.p - center) / radius;
         rec.set_face_normal(r, outward_normal);
         rec.mat = mat;
-
-        return true;
     }
 
+    /**
+     * @brief Retorna a caixa delimitadora da esfera.
+     * 
+     * @return aabb Caixa que envolve a esfera.
+     */
+    aabb bounding_box() const override { return bbox; }
+
   private:
     point3 center;                 /**< Centro da esfera. */
-    double radius;                 /**< Raio da esfera. */
-    shared_ptr<material> mat;      /**< Material associado à esfera. */
+    real radius;                   /**< Raio da esfera. */
+    material_id mat;               /**< Material associado à esfera. */
+    aabb bbox;                     /**< Caixa delimitadora da esfera. */
+    real p_error;                  /**< Erro absoluto máximo do ponto calculado em `shade`. */
+
+    /**
+     * @brief Testa todos os raios de um pacote contra a esfera, vários por instrução.
+     *
+     * Repete as operações de `intersect`, na mesma ordem, para cada posição do pacote, com o
+     * vetor SIMD do nível ativo (`run_simd`).
+     */
+    template <int N>
+    void intersect_simd(ray_packet<N>& packet) const {
+        run_simd<N>([&](auto lanes) RT_ALWAYS_INLINE {
+            intersect_lanes_simd<typename decltype(lanes)::type>(packet);
+        });
+    }
+
+    /**
+     * @brief Kernel genérico de `intersect_simd` para o vetor SIMD `V`.
+     */
+    template <typename V, int N>
+    RT_ALWAYS_INLINE inline void intersect_lanes_simd(ray_packet<N>& packet) const {
+        const V cx(center.x()), cy(center.y()), cz(center.z());
+        const V radius2(radius*radius);
+        const V t_min(packet.tmin);
+
+        for (int k = 0; k < N; k += V::width) {
+            const V dx = V::load(packet.dx + k);
+            const V dy = V::load(packet.dy + k);
+            const V dz = V::load(packet.dz + k);
+            const V ocx = V::load(packet.ox + k) - cx;
+            const V ocy = V::load(packet.oy + k) - cy;
+            const V ocz = V::load(packet.oz + k) - cz;
+            const V t_max = V::load(packet.tmax + k);
+
+            const V a = dx*dx + dy*dy + dz*dz;
+            const V half_b = ocx*dx + ocy*dy + ocz*dz;
+            const V c = (ocx*ocx + ocy*ocy + ocz*ocz) - radius2;
+            const V discriminant = half_b*half_b - a*c;
+
+            // Com discriminante negativo, as raízes são NaN e nenhuma comparação abaixo é verdadeira.
+            const V sqrtd = simd_sqrt(discriminant);
+            const V near_root = (-half_b - sqrtd) / a;
+            const V far_root = (-half_b + sqrtd) / a;
+            const auto near_hit = (t_min < near_root) & (near_root < t_max);
+            const auto far_hit = (t_min < far_root) & (far_root < t_max);
+            const V root = select(near_hit, near_root, far_root);
+
+            int bits = lane_bits(near_hit | far_hit);
+            if (!bits)
+                continue;
+
+            double roots[V::width];
+            root.store(roots);
+            for (int lane = 0; lane < V::width; lane++) {
+                if (bits & (1 << lane))
+                    packet.record(k + lane, roots[lane], this, 0, 0, 0);
+            }
+        }
+    }
 };
 
 #endif
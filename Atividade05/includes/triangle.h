@@ -30,7 +30,7 @@ class triangle : public hittable {
          * @param _C Vértice C do triângulo.
          * @param _material Material do triângulo.
          */
-        triangle(const vertex& _A, const vertex& _B, const vertex& _C, shared_ptr<material> _material): 
+        triangle(const vertex& _A, const vertex& _B, const vertex& _C, material_id _material): 
             A(_A), B(_B), C(_C), mat(_material){}
         
         /**
@@ -38,20 +38,20 @@ class triangle : public hittable {
          * 
          * @param r Raio a ser verificado.
          * @param ray_t Dados auxiliares de intervalo do raio.
-         * @param rec Registro de interseptação.
+         * @param h Registro da interseção (t e coordenadas baricêntricas).
          * @return true Se houver interseção.
          * @return false Se não houver interseção.
          */
-        bool hit(const ray& r, interval ray_t, hit_record& rec) const noexcept override {
+        bool intersect(const ray& r, interval ray_t, surface_hit& h) const noexcept override {
             vec3 e1 = B.coord - A.coord;
             vec3 e2 = C.coord - A.coord;
             vec3 normal_e1e2 = cross(e1, e2);
 
-            double nd = dot(normal_e1e2, r.direction());
+            real nd = dot(normal_e1e2, r.direction());
             if(fabs(nd) < 1e-8) return false;
 
-            double D = -dot(normal_e1e2, A.coord);
-            double t = -(dot(normal_e1e2, r.origin()) + D) / nd;
+            real D = -dot(normal_e1e2, A.coord);
+            real t = -(dot(normal_e1e2, r.origin()) + D) / nd;
             
             if(t < 0) return false;
 
@@ -62,7 +62,8 @@ class triangle : public hittable {
             vec3 edge0 = B.coord - A.coord; 
             vec3 vp0 = P - A.coord;
             vec3 vp = cross(edge0, vp0);
-            if (dot(normal_e1e2, vp) < 0) return false; 
+            real area_c = dot(normal_e1e2, vp);
+            if (area_c < 0) return false; 
         
             vec3 edge1 = C.coord - B.coord; 
             vec3 vp1 = P - B.coord;
@@ -72,19 +73,151 @@ class triangle : public hittable {
             vec3 edge2 = A.coord - C.coord; 
             vec3 vp2 = P - C.coord;
             vp = cross(edge2, vp2);
-            if (dot(normal_e1e2, vp) < 0) return false;
+            real area_b = dot(normal_e1e2, vp);
+            if (area_b < 0) return false;
 
-            rec.t = t;
-            rec.p = P;
-            vec3 color_normal = A.normal;
-            rec.set_face_normal(r, A.normal, color_normal);
-            rec.mat = mat;
+            // As áreas dos subtriângulos, normalizadas, são as coordenadas baricêntricas de B e C.
+            real area = normal_e1e2.length_squared();
+            h.t = t;
+            h.object = this;
+            h.prim = 0;
+            h.u = static_cast<float>(area_b / area);
+            h.v = static_cast<float>(area_c / area);
 
             return true;
         };
 
+        /**
+         * @brief Verifica se o raio atinge o triângulo em algum ponto de `ray_t`.
+         * 
+         * @param r Raio a ser verificado.
+         * @param ray_t Segmento do raio.
+         * @return true Se houver interseção.
+         */
+        bool any_hit(const ray& r, interval ray_t) const override {
+            occlusion_counters().primitives++;
+            surface_hit h;
+            return intersect(r, ray_t, h);
+        }
+
+        /**
+         * @brief Verifica a interseção de um pacote de raios com o triângulo (SIMD).
+         * 
+         * @param packet Pacote de raios.
+         */
+        void intersect_packet(ray_packet4& packet) const override { intersect_simd(packet); }
+        void intersect_packet(ray_packet8& packet) const override { intersect_simd(packet); }
+
+        /**
+         * @brief Calcula o ponto, a normal e o material da interseção com o triângulo.
+         * 
+         * @param r Raio incidente.
+         * @param h Interseção retornada por `intersect`.
+         * @param rec Registro de interseptação.
+         */
+        void shade(const ray& r, const surface_hit& h, hit_record& rec) const override {
+            rec.t = h.t;
+            rec.p = barycentric_point(A.coord, B.coord, C.coord, h.u, h.v, rec.p_error);
+            vec3 outward_normal = unit_vector(cross(B.coord - A.coord, C.coord - A.coord));
+            rec.set_face_normal(r, outward_normal, A.normal);
+            rec.mat = mat;
+        }
+
+        /**
+         * @brief Retorna a caixa delimitadora do triângulo.
+         * 
+         * @return aabb Caixa que envolve os três vértices, com espessura mínima em cada eixo.
+         */
+        aabb bounding_box() const override {
+            return aabb(aabb(A.coord, B.coord), aabb(C.coord, C.coord)).pad();
+        }
+
     public:
-        shared_ptr<material> mat; /**< Material do triângulo. */
+        material_id mat; /**< Material do triângulo. */
+
+    private:
+        /**
+         * @brief Produto escalar da normal do triângulo com `cross(edge, P - vertex)`, por posição.
+         */
+        template <typename V>
+        RT_ALWAYS_INLINE static inline V edge_area(const vec3& n, const vec3& edge, const point3& vertex,
+                                                   V px, V py, V pz) {
+            const V vx = px - V(vertex.x());
+            const V vy = py - V(vertex.y());
+            const V vz = pz - V(vertex.z());
+            const V cx = V(edge.y())*vz - V(edge.z())*vy;
+            const V cy = V(edge.z())*vx - V(edge.x())*vz;
+            const V cz = V(edge.x())*vy - V(edge.y())*vx;
+            return V(n.x())*cx + V(n.y())*cy + V(n.z())*cz;
+        }
+
+        /**
+         * @brief Testa todos os raios de um pacote contra o triângulo, vários por instrução.
+         *
+         * Repete as operações de `intersect`, na mesma ordem, para cada posição do pacote, com o
+         * vetor SIMD do nível ativo (`run_simd`).
+         */
+        template <int N>
+        void intersect_simd(ray_packet<N>& packet) const {
+            run_simd<N>([&](auto lanes) RT_ALWAYS_INLINE {
+                intersect_lanes_simd<typename decltype(lanes)::type>(packet);
+            });
+        }
+
+        /**
+         * @brief Kernel genérico de `intersect_simd` para o vetor SIMD `V`.
+         */
+        template <typename V, int N>
+        RT_ALWAYS_INLINE inline void intersect_lanes_simd(ray_packet<N>& packet) const {
+            const vec3 e1 = B.coord - A.coord;
+            const vec3 e2 = C.coord - A.coord;
+            const vec3 n = cross(e1, e2);
+            const vec3 edge1 = C.coord - B.coord;
+            const vec3 edge2 = A.coord - C.coord;
+            const double D = -dot(n, A.coord);
+            const double area = n.length_squared();
+
+            const V nx(n.x()), ny(n.y()), nz(n.z());
+            const V t_min(packet.tmin);
+            const V zero(0.0);
+
+            for (int k = 0; k < N; k += V::width) {
+                const V dx = V::load(packet.dx + k);
+                const V dy = V::load(packet.dy + k);
+                const V dz = V::load(packet.dz + k);
+                const V ox = V::load(packet.ox + k);
+                const V oy = V::load(packet.oy + k);
+                const V oz = V::load(packet.oz + k);
+
+                const V nd = nx*dx + ny*dy + nz*dz;
+                const V t = -((nx*ox + ny*oy + nz*oz) + V(D)) / nd;
+                auto valid = and_not((t_min < t) & (t < V::load(packet.tmax + k)),
+                                          (simd_abs(nd) < V(1e-8)) | (t < zero));
+                if (!lane_bits(valid))
+                    continue;
+
+                const V px = ox + t*dx;
+                const V py = oy + t*dy;
+                const V pz = oz + t*dz;
+                const V area_c = edge_area<V>(n, e1, A.coord, px, py, pz);
+                const V area_a = edge_area<V>(n, edge1, B.coord, px, py, pz);
+                const V area_b = edge_area<V>(n, edge2, C.coord, px, py, pz);
+                valid = and_not(valid, (area_c < zero) | (area_a < zero) | (area_b < zero));
+
+                int bits = lane_bits(valid);
+                if (!bits)
+                    continue;
+
+                double ts[V::width], us[V::width], vs[V::width];
+                t.store(ts);
+                (area_b / V(area)).store(us);
+                (area_c / V(area)).store(vs);
+                for (int lane = 0; lane < V::width; lane++) {
+                    if (bits & (1 << lane))
+                        packet.record(k + lane, ts[lane], this, 0, static_cast<float>(us[lane]), static_cast<float>(vs[lane]));
+                }
+            }
+        }
 };
 
 #endif
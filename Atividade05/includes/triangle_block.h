@@ -0,0 +1,287 @@
+/**
+ * @file triangle_block.h
+ * @brief Arquivo de implementação do bloco de triângulos em SoA e do kernel de interseção em lote
+ */
+
+#ifndef TRIANGLE_BLOCK_H
+#define TRIANGLE_BLOCK_H
+
+#include "./utils.h"
+#include "./simd_dispatch.h"
+
+#if RT_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Raio em precisão simples, usado pelos kernels de interseção em lote.
+ */
+struct ray_f {
+    float o[3]; /**< Origem do raio. */
+    float d[3]; /**< Direção do raio. */
+
+    /**
+     * @brief Converte um raio em precisão dupla.
+     *
+     * @param r Raio original.
+     */
+    explicit ray_f(const ray& r) {
+        const point3 origin = r.origin();
+        const vec3 direction = r.direction();
+        for (int a = 0; a < 3; a++) {
+            o[a] = static_cast<float>(origin[a]);
+            d[a] = static_cast<float>(direction[a]);
+        }
+    }
+};
+
+/**
+ * @brief Bloco de até 8 triângulos pré-processados para o algoritmo de Möller–Trumbore.
+ *
+ * Cada triângulo é guardado como o vértice `v0` e as arestas `e1 = v1 - v0` e `e2 = v2 - v0`,
+ * já calculadas, em estrutura de vetores (SoA) de `float`: cada componente ocupa um vetor
+ * de 8 posições, pronto para ser carregado em um registrador SSE/AVX.
+ * Posições não utilizadas têm arestas nulas e nunca são atingidas.
+ */
+struct triangle_block {
+    static const int width = 8; /**< Quantidade de triângulos por bloco. */
+
+    float v0[3][width] = {}; /**< Vértice de referência (x, y, z). */
+    float e1[3][width] = {}; /**< Primeira aresta (x, y, z). */
+    float e2[3][width] = {}; /**< Segunda aresta (x, y, z). */
+    int prim[width] = {-1, -1, -1, -1, -1, -1, -1, -1}; /**< Índice de cada triângulo (-1 se vazio). */
+
+    /**
+     * @brief Armazena um triângulo em uma posição do bloco.
+     *
+     * @param lane Posição no bloco.
+     * @param a Primeiro vértice.
+     * @param b Segundo vértice.
+     * @param c Terceiro vértice.
+     * @param id Índice do triângulo.
+     */
+    void set(int lane, const point3& a, const point3& b, const point3& c, int id) {
+        for (int k = 0; k < 3; k++) {
+            v0[k][lane] = static_cast<float>(a[k]);
+            e1[k][lane] = static_cast<float>(b[k] - a[k]);
+            e2[k][lane] = static_cast<float>(c[k] - a[k]);
+        }
+        prim[lane] = id;
+    }
+};
+
+/**
+ * @brief Resultado de um teste de interseção em lote.
+ */
+struct block_hit {
+    int   lane = -1;      /**< Posição do triângulo atingido no bloco (-1 se nenhum). */
+    float t = 0;          /**< Parâmetro t do raio na interseção. */
+    float u = 0, v = 0;   /**< Coordenadas baricêntricas da interseção. */
+};
+
+/**
+ * @brief Testa um triângulo do bloco (versão escalar do kernel).
+ */
+inline bool intersect_lane(const triangle_block& b, int lane, const ray_f& r, float tmin, float& tmax, block_hit& hit) {
+    const float e1x = b.e1[0][lane], e1y = b.e1[1][lane], e1z = b.e1[2][lane];
+    const float e2x = b.e2[0][lane], e2y = b.e2[1][lane], e2z = b.e2[2][lane];
+
+    const float px = r.d[1]*e2z - r.d[2]*e2y;
+    const float py = r.d[2]*e2x - r.d[0]*e2z;
+    const float pz = r.d[0]*e2y - r.d[1]*e2x;
+    const float det = e1x*px + e1y*py + e1z*pz;
+    if (!(fabsf(det) > 1e-12f))
+        return false;
+    const float inv_det = 1.0f / det;
+
+    const float tx = r.o[0] - b.v0[0][lane], ty = r.o[1] - b.v0[1][lane], tz = r.o[2] - b.v0[2][lane];
+    const float u = (tx*px + ty*py + tz*pz) * inv_det;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    const float qx = ty*e1z - tz*e1y;
+    const float qy = tz*e1x - tx*e1z;
+    const float qz = tx*e1y - ty*e1x;
+    const float v = (r.d[0]*qx + r.d[1]*qy + r.d[2]*qz) * inv_det;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    const float t = (e2x*qx + e2y*qy + e2z*qz) * inv_det;
+    if (!(t > tmin && t < tmax))
+        return false;
+
+    tmax = t;
+    hit.lane = lane;
+    hit.t = t;
+    hit.u = u;
+    hit.v = v;
+    return true;
+}
+
+/**
+ * @brief Testa todos os triângulos de um bloco sem SIMD.
+ */
+inline bool intersect_block_scalar(const triangle_block& b, const ray_f& r, float tmin, float& tmax, block_hit& hit) {
+    bool hit_anything = false;
+    for (int lane = 0; lane < triangle_block::width; lane++) {
+        if (intersect_lane(b, lane, r, tmin, tmax, hit))
+            hit_anything = true;
+    }
+    return hit_anything;
+}
+
+#if RT_X86_DISPATCH
+/**
+ * @brief Testa 4 triângulos do bloco, a partir de `offset`, com SSE.
+ */
+RT_TARGET("sse2") inline bool intersect_block_sse(const triangle_block& b, int offset, const ray_f& r, float tmin, float& tmax, block_hit& hit) {
+    const __m128 dx = _mm_set1_ps(r.d[0]), dy = _mm_set1_ps(r.d[1]), dz = _mm_set1_ps(r.d[2]);
+    const __m128 e1x = _mm_loadu_ps(b.e1[0] + offset), e1y = _mm_loadu_ps(b.e1[1] + offset), e1z = _mm_loadu_ps(b.e1[2] + offset);
+    const __m128 e2x = _mm_loadu_ps(b.e2[0] + offset), e2y = _mm_loadu_ps(b.e2[1] + offset), e2z = _mm_loadu_ps(b.e2[2] + offset);
+
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    const __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    const __m128 tx = _mm_sub_ps(_mm_set1_ps(r.o[0]), _mm_loadu_ps(b.v0[0] + offset));
+    const __m128 ty = _mm_sub_ps(_mm_set1_ps(r.o[1]), _mm_loadu_ps(b.v0[1] + offset));
+    const __m128 tz = _mm_sub_ps(_mm_set1_ps(r.o[2]), _mm_loadu_ps(b.v0[2] + offset));
+    const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inv_det);
+
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+    const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 abs_det = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    __m128 mask = _mm_cmpgt_ps(abs_det, _mm_set1_ps(1e-12f));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, _mm_set1_ps(tmin)));
+    mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(tmax)));
+
+    int bits = _mm_movemask_ps(mask);
+    if (bits == 0)
+        return false;
+
+    alignas(16) float ts[4], us[4], vs[4];
+    _mm_store_ps(ts, t);
+    _mm_store_ps(us, u);
+    _mm_store_ps(vs, v);
+
+    int best = -1;
+    for (int lane = 0; lane < 4; lane++) {
+        if ((bits >> lane) & 1) {
+            if (best < 0 || ts[lane] < ts[best])
+                best = lane;
+        }
+    }
+
+    tmax = ts[best];
+    hit.lane = offset + best;
+    hit.t = ts[best];
+    hit.u = us[best];
+    hit.v = vs[best];
+    return true;
+}
+
+/**
+ * @brief Testa os 8 triângulos do bloco de uma vez com AVX.
+ */
+RT_TARGET("avx2") inline bool intersect_block_avx(const triangle_block& b, const ray_f& r, float tmin, float& tmax, block_hit& hit) {
+    const __m256 dx = _mm256_set1_ps(r.d[0]), dy = _mm256_set1_ps(r.d[1]), dz = _mm256_set1_ps(r.d[2]);
+    const __m256 e1x = _mm256_loadu_ps(b.e1[0]), e1y = _mm256_loadu_ps(b.e1[1]), e1z = _mm256_loadu_ps(b.e1[2]);
+    const __m256 e2x = _mm256_loadu_ps(b.e2[0]), e2y = _mm256_loadu_ps(b.e2[1]), e2z = _mm256_loadu_ps(b.e2[2]);
+
+    const __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+    const __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+    const __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+    const __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+    const __m256 inv_det = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+
+    const __m256 tx = _mm256_sub_ps(_mm256_set1_ps(r.o[0]), _mm256_loadu_ps(b.v0[0]));
+    const __m256 ty = _mm256_sub_ps(_mm256_set1_ps(r.o[1]), _mm256_loadu_ps(b.v0[1]));
+    const __m256 tz = _mm256_sub_ps(_mm256_set1_ps(r.o[2]), _mm256_loadu_ps(b.v0[2]));
+    const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, px), _mm256_mul_ps(ty, py)), _mm256_mul_ps(tz, pz)), inv_det);
+
+    const __m256 qx = _mm256_sub_ps(_mm256_mul_ps(ty, e1z), _mm256_mul_ps(tz, e1y));
+    const __m256 qy = _mm256_sub_ps(_mm256_mul_ps(tz, e1x), _mm256_mul_ps(tx, e1z));
+    const __m256 qz = _mm256_sub_ps(_mm256_mul_ps(tx, e1y), _mm256_mul_ps(ty, e1x));
+    const __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv_det);
+    const __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv_det);
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 abs_det = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), det);
+    __m256 mask = _mm256_cmp_ps(abs_det, _mm256_set1_ps(1e-12f), _CMP_GT_OQ);
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, _mm256_set1_ps(tmin), _CMP_GT_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, _mm256_set1_ps(tmax), _CMP_LT_OQ));
+
+    int bits = _mm256_movemask_ps(mask);
+    if (bits == 0)
+        return false;
+
+    alignas(32) float ts[8], us[8], vs[8];
+    _mm256_store_ps(ts, t);
+    _mm256_store_ps(us, u);
+    _mm256_store_ps(vs, v);
+
+    int best = -1;
+    for (int lane = 0; lane < 8; lane++) {
+        if ((bits >> lane) & 1) {
+            if (best < 0 || ts[lane] < ts[best])
+                best = lane;
+        }
+    }
+
+    tmax = ts[best];
+    hit.lane = best;
+    hit.t = ts[best];
+    hit.u = us[best];
+    hit.v = vs[best];
+    return true;
+}
+#endif
+
+/**
+ * @brief Testa todos os triângulos de um bloco e mantém a interseção mais próxima.
+ *
+ * Usa o kernel do nível SIMD escolhido na inicialização (`active_simd_level`): AVX2 (8 triângulos
+ * por instrução, também em CPUs com AVX-512, já que o bloco tem 8 triângulos), SSE (2 x 4
+ * triângulos) ou a versão escalar.
+ *
+ * @param b Bloco de triângulos.
+ * @param r Raio em precisão simples.
+ * @param tmin Menor t aceito.
+ * @param tmax Maior t aceito; reduzido para o t da interseção encontrada.
+ * @param hit Resultado da interseção mais próxima.
+ * @return true Se algum triângulo do bloco foi atingido antes de `tmax`.
+ * @return false Caso contrário.
+ */
+inline bool intersect_block(const triangle_block& b, const ray_f& r, float tmin, float& tmax, block_hit& hit) {
+#if RT_X86_DISPATCH
+    switch (active_simd_level()) {
+        case simd_level::avx512:
+        case simd_level::avx2:
+            return intersect_block_avx(b, r, tmin, tmax, hit);
+        case simd_level::sse42:
+        case simd_level::sse2: {
+            bool low = intersect_block_sse(b, 0, r, tmin, tmax, hit);
+            bool high = intersect_block_sse(b, 4, r, tmin, tmax, hit);
+            return low || high;
+        }
+        default:
+            break;
+    }
+#endif
+    return intersect_block_scalar(b, r, tmin, tmax, hit);
+}
+
+#endif
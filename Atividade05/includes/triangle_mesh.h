@@ -0,0 +1,289 @@
+/**
+ * @file triangle_mesh.h
+ * @brief Arquivo de implementação da classe Triangle_mesh
+ */
+
+#ifndef TRIANGLE_MESH_H
+#define TRIANGLE_MESH_H
+
+#include "./hittable.h"
+#include "./triangle_block.h"
+#include "./bvh.h"
+#include "../../Atividade02/includes/transform.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Buffers de uma malha indexada.
+ *
+ * Cada vértice é armazenado uma única vez; os triângulos referenciam as posições e as normais
+ * por índice, como no formato OBJ.
+ */
+struct mesh_data {
+    std::vector<float> positions;            /**< Posições dos vértices (x, y, z consecutivos). */
+    std::vector<float> normals;              /**< Normais dos vértices (x, y, z consecutivos). */
+    std::vector<uint32_t> position_indices;  /**< Três índices de posição por triângulo. */
+    std::vector<uint32_t> normal_indices;    /**< Três índices de normal por triângulo (vazio se não houver normais). */
+
+    /**
+     * @brief Retorna a quantidade de triângulos da malha.
+     *
+     * @return size_t Quantidade de triângulos.
+     */
+    size_t triangle_count() const { return position_indices.size() / 3; }
+
+    /**
+     * @brief Retorna a posição de um vértice.
+     *
+     * @param index Índice da posição.
+     * @return point3 Posição do vértice.
+     */
+    point3 position(uint32_t index) const {
+        return point3(positions[3*index], positions[3*index + 1], positions[3*index + 2]);
+    }
+
+    /**
+     * @brief Retorna uma normal.
+     *
+     * @param index Índice da normal.
+     * @return vec3 Normal.
+     */
+    vec3 normal(uint32_t index) const {
+        return vec3(normals[3*index], normals[3*index + 1], normals[3*index + 2]);
+    }
+
+    /**
+     * @brief Aplica uma transformação afim a todos os vértices e normais da malha.
+     *
+     * As posições passam por `transform_points` e as normais pela matriz normal (inversa
+     * transposta da parte 3x3), renormalizadas em `transform_normals`; os dois laços processam
+     * 4 ou 8 vértices por iteração e são limitados pela largura de banda da memória.
+     *
+     * @param m Matriz de transformação (translação, rotação, escala ou uma composição delas).
+     */
+    void transform(const mat4& m) {
+        transform_points(m, positions.data(), positions.data(), positions.size() / 3);
+        if (!normals.empty())
+            transform_normals(normal_matrix(m), normals.data(), normals.data(), normals.size() / 3);
+    }
+};
+
+/**
+ * @brief Malha de triângulos indexada, testada como um único objeto da cena.
+ *
+ * A malha compartilha os buffers de posições, normais e índices (`mesh_data`) e mantém uma BVH
+ * própria, com folhas de até 8 triângulos convertidas em `triangle_block` (Möller–Trumbore
+ * pré-calculado em SoA de `float`). Um raio faz uma única chamada virtual por malha, em vez de
+ * uma por triângulo.
+ */
+class triangle_mesh : public hittable {
+  public:
+    /**
+     * @brief Construtor da classe Triangle_mesh.
+     *
+     * @param _data Buffers da malha (podem ser compartilhados entre malhas).
+     * @param _material Material dos triângulos.
+     */
+    triangle_mesh(shared_ptr<const mesh_data> _data, material_id _material)
+      : data(_data), mat(_material)
+    {
+        const size_t count = data->triangle_count();
+        std::vector<aabb> boxes;
+        boxes.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            point3 a, b, c;
+            vertices(static_cast<uint32_t>(i), a, b, c);
+            boxes.push_back(aabb(aabb(a, b), aabb(c, c)).pad());
+        }
+
+        tree.build(boxes, triangle_block::width, triangle_block::width);
+
+        // Nas folhas, `first` passa a indicar o bloco com os triângulos da folha.
+        for (auto& node : tree.nodes) {
+            if (node.count == 0)
+                continue;
+
+            triangle_block block;
+            for (int lane = 0; lane < node.count; lane++) {
+                int id = tree.indices[node.first + lane];
+                point3 a, b, c;
+                vertices(static_cast<uint32_t>(id), a, b, c);
+                block.set(lane, a, b, c, id);
+            }
+            node.first = static_cast<int>(blocks.size());
+            blocks.push_back(block);
+        }
+        tree.indices.clear();
+        tree.indices.shrink_to_fit();
+        tree.nodes.shrink_to_fit();
+
+        bbox = tree.nodes.empty() ? aabb::empty : tree.nodes[0].bbox;
+    }
+
+    /**
+     * @brief Verifica a interseção mais próxima entre o raio e os triângulos da malha.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Dados auxiliares de intervalo do raio.
+     * @param h Registro da interseção (t, triângulo e coordenadas baricêntricas).
+     * @return true Se houver interseção.
+     * @return false Se não houver interseção.
+     */
+    bool intersect(const ray& r, interval ray_t, surface_hit& h) const noexcept override {
+        const ray_f rf(r);
+        block_hit closest;
+        int closest_block = -1;
+
+        tree.traverse_leaves(r, ray_t, [&](const bvh_tree_node& leaf, interval& t) {
+            block_hit candidate;
+            float tmax = static_cast<float>(t.max);
+            if (!intersect_block(blocks[leaf.first], rf, static_cast<float>(t.min), tmax, candidate))
+                return false;
+            // A conversão para float pode arredondar o limite para cima.
+            if (!(candidate.t < t.max))
+                return false;
+            closest = candidate;
+            closest_block = leaf.first;
+            t.max = closest.t;
+            return true;
+        });
+
+        if (closest_block < 0)
+            return false;
+
+        h.t = closest.t;
+        h.object = this;
+        h.prim = static_cast<uint32_t>(blocks[closest_block].prim[closest.lane]);
+        h.u = closest.u;
+        h.v = closest.v;
+        return true;
+    }
+
+    /**
+     * @brief Verifica se algum triângulo da malha bloqueia o segmento, parando no primeiro bloco atingido.
+     *
+     * @param r Raio a ser verificado.
+     * @param ray_t Segmento do raio.
+     * @return true Se algum triângulo intercepta o segmento.
+     */
+    bool any_hit(const ray& r, interval ray_t) const override {
+        const ray_f rf(r);
+        return tree.traverse_any(r, ray_t, [&](const bvh_tree_node& leaf, const interval& t) {
+            occlusion_counters().primitives++;
+            block_hit candidate;
+            float tmax = static_cast<float>(t.max);
+            return intersect_block(blocks[leaf.first], rf, static_cast<float>(t.min), tmax, candidate)
+                && candidate.t < t.max;
+        });
+    }
+
+    /**
+     * @brief Percorre a BVH da malha com um pacote de raios.
+     *
+     * A travessia é feita uma vez para o pacote; em cada folha, o bloco de triângulos é testado
+     * com o kernel em lote para cada raio ativo.
+     *
+     * @param packet Pacote de raios.
+     */
+    void intersect_packet(ray_packet4& packet) const override { intersect_leaves(packet); }
+    void intersect_packet(ray_packet8& packet) const override { intersect_leaves(packet); }
+
+    /**
+     * @brief Calcula o ponto, a normal interpolada e o material da interseção com a malha.
+     *
+     * @param r Raio incidente.
+     * @param h Interseção retornada por `intersect`.
+     * @param rec Registro de interseptação.
+     */
+    void shade(const ray& r, const surface_hit& h, hit_record& rec) const override {
+        rec.t = h.t;
+        point3 a, b, c;
+        vertices(h.prim, a, b, c);
+        rec.p = barycentric_point(a, b, c, h.u, h.v, rec.p_error);
+        vec3 outward_normal = unit_vector(cross(b - a, c - a));
+        rec.set_face_normal(r, outward_normal, shading_normal(h.prim, h.u, h.v));
+        rec.mat = mat;
+    }
+
+    /**
+     * @brief Retorna a caixa delimitadora da malha.
+     *
+     * @return aabb Caixa que envolve todos os triângulos.
+     */
+    aabb bounding_box() const override { return bbox; }
+
+    /**
+     * @brief Retorna a memória ocupada pelos buffers da malha e pela sua BVH.
+     *
+     * @return size_t Quantidade de bytes.
+     */
+    size_t memory_usage() const {
+        return data->positions.capacity() * sizeof(float)
+             + data->normals.capacity() * sizeof(float)
+             + data->position_indices.capacity() * sizeof(uint32_t)
+             + data->normal_indices.capacity() * sizeof(uint32_t)
+             + blocks.capacity() * sizeof(triangle_block)
+             + tree.nodes.capacity() * sizeof(bvh_tree_node);
+    }
+
+  private:
+    shared_ptr<const mesh_data> data;   /**< Buffers compartilhados da malha. */
+    std::vector<triangle_block> blocks; /**< Triângulos pré-processados, um bloco por folha. */
+    bvh_tree tree;                      /**< Hierarquia sobre os triângulos. */
+    material_id mat;                    /**< Material dos triângulos. */
+    aabb bbox;                          /**< Caixa delimitadora da malha. */
+
+    /**
+     * @brief Testa os blocos das folhas atingidas por um pacote, raio a raio.
+     */
+    template <int N>
+    void intersect_leaves(ray_packet<N>& packet) const {
+        tree.traverse_packet(packet, [&](const bvh_tree_node& leaf) {
+            const triangle_block& block = blocks[leaf.first];
+            for (int lane = 0; lane < N; lane++) {
+                if (!packet.active(lane))
+                    continue;
+                block_hit candidate;
+                float tmax = static_cast<float>(packet.tmax[lane]);
+                if (!intersect_block(block, ray_f(packet.get_ray(lane)), static_cast<float>(packet.tmin), tmax, candidate))
+                    continue;
+                // A conversão para float pode arredondar o limite para cima.
+                if (!(candidate.t < packet.tmax[lane]))
+                    continue;
+                packet.record(lane, candidate.t, this, static_cast<uint32_t>(block.prim[candidate.lane]),
+                              candidate.u, candidate.v);
+            }
+        });
+    }
+
+    /**
+     * @brief Obtém as posições dos três vértices de um triângulo.
+     */
+    void vertices(uint32_t id, point3& a, point3& b, point3& c) const {
+        a = data->position(data->position_indices[3*id]);
+        b = data->position(data->position_indices[3*id + 1]);
+        c = data->position(data->position_indices[3*id + 2]);
+    }
+
+    /**
+     * @brief Calcula a normal de sombreamento no ponto (u, v) do triângulo.
+     *
+     * Interpola as normais dos vértices quando a malha as possui; caso contrário, usa a normal
+     * geométrica do triângulo.
+     */
+    vec3 shading_normal(uint32_t id, float u, float v) const {
+        if (data->normal_indices.empty()) {
+            point3 a, b, c;
+            vertices(id, a, b, c);
+            return unit_vector(cross(b - a, c - a));
+        }
+
+        const real w = 1 - u - v;
+        return unit_vector(w * data->normal(data->normal_indices[3*id])
+                         + u * data->normal(data->normal_indices[3*id + 1])
+                         + v * data->normal(data->normal_indices[3*id + 2]));
+    }
+};
+
+#endif
@@ -7,9 +7,9 @@
 #define UTILS_H
 
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <memory>
-#include <random>
 
 // Usings
 using std::shared_ptr;
@@ -30,15 +30,95 @@ inline double degrees_to_radians(double degrees) {
     return degrees * pi / 180.0;
 }
 
+/**
+ * @brief Gerador de números aleatórios PCG32 (permuted congruential generator).
+ * 
+ * Possui apenas 16 bytes de estado e gera cada número com uma multiplicação e uma rotação,
+ * o que o torna bem mais leve que o Mersenne Twister no laço de renderização.
+ */
+class pcg32 {
+  public:
+    /**
+     * @brief Reinicia o gerador.
+     * 
+     * @param initstate Estado inicial.
+     * @param initseq Sequência (fluxo) do gerador; fluxos diferentes são independentes.
+     */
+    void seed(uint64_t initstate, uint64_t initseq) {
+        state = 0u;
+        inc = (initseq << 1u) | 1u;
+        next();
+        state += initstate;
+        next();
+    }
+
+    /**
+     * @brief Gera o próximo número de 32 bits.
+     * 
+     * @return uint32_t Número gerado.
+     */
+    uint32_t next() {
+        uint64_t oldstate = state;
+        state = oldstate * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((oldstate >> 18u) ^ oldstate) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(oldstate >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
+  private:
+    uint64_t state = 0x853c49e6748fea9bULL; /**< Estado interno. */
+    uint64_t inc   = 0xda3e39cb94b95bdbULL; /**< Incremento (define o fluxo). */
+};
+
+/**
+ * @brief Retorna o gerador de números aleatórios da thread atual.
+ * 
+ * Cada thread possui o seu próprio gerador, evitando condições de corrida na renderização paralela.
+ * 
+ * @return pcg32& Gerador da thread atual.
+ */
+inline pcg32& random_generator() {
+    thread_local pcg32 generator;
+    return generator;
+}
+
+/**
+ * @brief Embaralha os bits de um inteiro de 64 bits (finalizador do SplitMix64).
+ * 
+ * @param v Valor a ser embaralhado.
+ * @return uint64_t Valor embaralhado.
+ */
+inline uint64_t mix_bits(uint64_t v) {
+    v ^= (v >> 31);
+    v *= 0x7fb5d329728ea185ULL;
+    v ^= (v >> 27);
+    v *= 0x81dadef4bc2dd44dULL;
+    v ^= (v >> 33);
+    return v;
+}
+
+/**
+ * @brief Reinicia o gerador da thread atual para um ponto do caminho de um raio.
+ * 
+ * A semente depende apenas do pixel, da amostra e do número do rebatimento, então cada
+ * caminho recebe sempre a mesma sequência, independentemente da thread que o renderiza.
+ * 
+ * @param pixel Índice do pixel na imagem.
+ * @param sample Índice da amostra do pixel.
+ * @param bounce Número do rebatimento (0 para o raio da câmera).
+ */
+inline void seed_random(uint64_t pixel, uint32_t sample, uint32_t bounce) {
+    uint64_t key = mix_bits((pixel << 32) ^ sample);
+    random_generator().seed(key, mix_bits(key ^ bounce));
+}
+
 /**
  * @brief Gera um número aleatório do tipo double no intervalo [0, 1).
  * 
  * @return double Número aleatório gerado.
  */
 inline double random_double() {
-    static std::uniform_real_distribution<double> distribution(0.0, 1.0);
-    static std::mt19937 generator;
-    return distribution(generator);
+    return random_generator().next() * (1.0 / 4294967296.0);
 }
 
 /**
@@ -49,14 +129,12 @@ inline double random_double() {
  * @return double Número aleatório gerado.
  */
 inline double random_double(double min, double max) {
-    static std::uniform_real_distribution<double> distribution(min, max);
-    static std::mt19937 generator;
-    return distribution(generator);
+    return min + (max - min) * random_double();
 }
 
 // Common headers
+#include "../../Atividade02/includes/vec3.h"
 #include "./interval.h"
 #include "../../Atividade04/includes/ray.h"
-#include "../../Atividade02/includes/vec3.h"
 
 #endif
@@ -0,0 +1,210 @@
+/**
+ * @file wavefront.h
+ * @brief Arquivo de implementação das filas SoA da renderização em frente de onda (wavefront)
+ */
+
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "./hittable.h"
+#include "./color.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Fila de raios ativos, em estrutura de vetores (SoA).
+ *
+ * Cada entrada guarda o raio do próximo segmento, a atenuação acumulada do caminho e o índice
+ * do caminho dentro do lote.
+ */
+struct ray_queue {
+    std::vector<real> origin_x, origin_y, origin_z;          /**< Origens dos raios. */
+    std::vector<real> direction_x, direction_y, direction_z; /**< Direções dos raios. */
+    std::vector<real> throughput_r, throughput_g, throughput_b; /**< Atenuação acumulada dos caminhos. */
+    std::vector<uint32_t> path;                                /**< Índice do caminho no lote. */
+
+    /**
+     * @brief Retorna a quantidade de raios na fila.
+     */
+    size_t size() const { return path.size(); }
+
+    /**
+     * @brief Esvazia a fila, mantendo a memória alocada.
+     */
+    void clear() {
+        origin_x.clear(); origin_y.clear(); origin_z.clear();
+        direction_x.clear(); direction_y.clear(); direction_z.clear();
+        throughput_r.clear(); throughput_g.clear(); throughput_b.clear();
+        path.clear();
+    }
+
+    /**
+     * @brief Adiciona um raio ao final da fila.
+     *
+     * @param r Raio do próximo segmento.
+     * @param throughput Atenuação acumulada do caminho.
+     * @param path_index Índice do caminho no lote.
+     */
+    void push(const ray& r, const color& throughput, uint32_t path_index) {
+        origin_x.push_back(r.origin().x());
+        origin_y.push_back(r.origin().y());
+        origin_z.push_back(r.origin().z());
+        direction_x.push_back(r.direction().x());
+        direction_y.push_back(r.direction().y());
+        direction_z.push_back(r.direction().z());
+        throughput_r.push_back(throughput.x());
+        throughput_g.push_back(throughput.y());
+        throughput_b.push_back(throughput.z());
+        path.push_back(path_index);
+    }
+
+    /**
+     * @brief Retorna o raio de uma entrada.
+     */
+    ray get_ray(size_t i) const {
+        return ray(point3(origin_x[i], origin_y[i], origin_z[i]), vec3(direction_x[i], direction_y[i], direction_z[i]));
+    }
+
+    /**
+     * @brief Retorna a atenuação acumulada de uma entrada.
+     */
+    color throughput(size_t i) const {
+        return color(throughput_r[i], throughput_g[i], throughput_b[i]);
+    }
+};
+
+/**
+ * @brief Fila de interseções encontradas no estágio de interseção, em SoA.
+ */
+struct hit_queue {
+    std::vector<uint32_t> entry;          /**< Entrada correspondente na `ray_queue`. */
+    std::vector<real> t;                  /**< Parâmetro t da interseção. */
+    std::vector<const hittable*> object;  /**< Primitiva atingida. */
+    std::vector<uint32_t> prim;           /**< Triângulo atingido dentro da primitiva. */
+    std::vector<float> u, v;              /**< Coordenadas baricêntricas. */
+
+    /**
+     * @brief Retorna a quantidade de interseções na fila.
+     */
+    size_t size() const { return entry.size(); }
+
+    /**
+     * @brief Esvazia a fila, mantendo a memória alocada.
+     */
+    void clear() {
+        entry.clear(); t.clear(); object.clear(); prim.clear(); u.clear(); v.clear();
+    }
+
+    /**
+     * @brief Adiciona uma interseção ao final da fila.
+     *
+     * @param ray_entry Entrada do raio na `ray_queue`.
+     * @param h Interseção encontrada.
+     */
+    void push(uint32_t ray_entry, const surface_hit& h) {
+        entry.push_back(ray_entry);
+        t.push_back(h.t);
+        object.push_back(h.object);
+        prim.push_back(h.prim);
+        u.push_back(h.u);
+        v.push_back(h.v);
+    }
+
+    /**
+     * @brief Retorna uma interseção da fila.
+     */
+    surface_hit get(size_t i) const {
+        surface_hit h;
+        h.t = t[i];
+        h.object = object[i];
+        h.prim = prim[i];
+        h.u = u[i];
+        h.v = v[i];
+        return h;
+    }
+};
+
+/**
+ * @brief Fila de pontos sombreados (ponto, normal e material), em SoA.
+ *
+ * Preenchida pelo estágio de sombreamento da superfície e ordenada por tipo de material antes
+ * do espalhamento, para que cada tipo de material seja processado em um único laço.
+ */
+struct shading_queue {
+    std::vector<uint32_t> entry;                     /**< Entrada correspondente na `ray_queue`. */
+    std::vector<real> p_x, p_y, p_z;                 /**< Pontos de interseção. */
+    std::vector<real> normal_x, normal_y, normal_z;   /**< Normais de sombreamento. */
+    std::vector<real> geometric_x, geometric_y, geometric_z; /**< Normais geométricas. */
+    std::vector<real> t;                             /**< Parâmetro t da interseção. */
+    std::vector<real> p_error;                       /**< Erro absoluto máximo dos pontos. */
+    std::vector<uint8_t> front_face;                 /**< Indica se a face frontal foi atingida. */
+    std::vector<material_id> mat;                    /**< Material atingido. */
+
+    /**
+     * @brief Retorna a quantidade de pontos na fila.
+     */
+    size_t size() const { return entry.size(); }
+
+    /**
+     * @brief Esvazia a fila, mantendo a memória alocada.
+     */
+    void clear() {
+        entry.clear(); p_x.clear(); p_y.clear(); p_z.clear();
+        normal_x.clear(); normal_y.clear(); normal_z.clear();
+        geometric_x.clear(); geometric_y.clear(); geometric_z.clear();
+        t.clear(); p_error.clear(); front_face.clear(); mat.clear();
+    }
+
+    /**
+     * @brief Adiciona um ponto sombreado ao final da fila.
+     *
+     * @param ray_entry Entrada do raio na `ray_queue`.
+     * @param rec Registro completo da interseção.
+     */
+    void push(uint32_t ray_entry, const hit_record& rec) {
+        entry.push_back(ray_entry);
+        p_x.push_back(rec.p.x());
+        p_y.push_back(rec.p.y());
+        p_z.push_back(rec.p.z());
+        normal_x.push_back(rec.normal.x());
+        normal_y.push_back(rec.normal.y());
+        normal_z.push_back(rec.normal.z());
+        geometric_x.push_back(rec.geometric_normal.x());
+        geometric_y.push_back(rec.geometric_normal.y());
+        geometric_z.push_back(rec.geometric_normal.z());
+        t.push_back(rec.t);
+        p_error.push_back(rec.p_error);
+        front_face.push_back(rec.front_face);
+        mat.push_back(rec.mat);
+    }
+
+    /**
+     * @brief Retorna o registro de interseção de uma entrada.
+     */
+    hit_record get(size_t i) const {
+        hit_record rec;
+        rec.p = point3(p_x[i], p_y[i], p_z[i]);
+        rec.normal = vec3(normal_x[i], normal_y[i], normal_z[i]);
+        rec.geometric_normal = vec3(geometric_x[i], geometric_y[i], geometric_z[i]);
+        rec.t = t[i];
+        rec.p_error = p_error[i];
+        rec.front_face = front_face[i] != 0;
+        rec.mat = mat[i];
+        return rec;
+    }
+};
+
+/**
+ * @brief Filas usadas por uma thread na renderização em frente de onda.
+ */
+struct wavefront_queues {
+    ray_queue rays;                /**< Raios do rebatimento atual. */
+    ray_queue next_rays;           /**< Raios gerados para o próximo rebatimento. */
+    hit_queue hits;                /**< Interseções do rebatimento atual. */
+    shading_queue surfaces;        /**< Pontos sombreados do rebatimento atual. */
+    std::vector<uint32_t> order;   /**< Índices de `surfaces` ordenados por tipo de material. */
+    std::vector<color> radiance;   /**< Radiância de cada caminho do lote. */
+};
+
+#endif